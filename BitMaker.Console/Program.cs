@@ -1,6 +1,11 @@
-﻿using System.Threading;
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading;
 
 using BitMaker.Miner;
+using BitMaker.Miner.Sse;
 
 namespace BitMaker.Console
 {
@@ -10,8 +15,12 @@ namespace BitMaker.Console
 
         private static MinerHost engine;
 
-        public static void Main(string[] args)
+        public static int Main(string[] args)
         {
+            // verify block headers instead of mining
+            if (args.Length > 0 && string.Equals(args[0], "/verify", StringComparison.OrdinalIgnoreCase))
+                return Verify(args.Skip(1));
+
             engine = new MinerHost();
             engine.Start();
 
@@ -31,6 +40,43 @@ namespace BitMaker.Console
 
             global::System.Console.WriteLine("Total Hashes: {0}", engine.HashCount);
             global::System.Console.ReadLine();
+            return 0;
+        }
+
+        /// <summary>
+        /// Verifies the proof of work of the headers in the given files, which may contain wildcards such as blk*.dat.
+        /// Returns non-zero if any header fails.
+        /// </summary>
+        /// <param name="patterns"></param>
+        /// <returns></returns>
+        private static int Verify(IEnumerable<string> patterns)
+        {
+            var paths = patterns
+                .SelectMany(i => Directory.GetFiles(Path.GetDirectoryName(Path.GetFullPath(i)), Path.GetFileName(i)).OrderBy(j => j))
+                .ToArray();
+
+            long headers = 0, bytes = 0, invalid = 0;
+            var elapsed = TimeSpan.Zero;
+
+            foreach (var path in paths)
+            {
+                var result = HeaderVerifier.Verify(path);
+                headers += result.Headers;
+                bytes += result.Bytes;
+                invalid += result.Invalid.Count;
+                elapsed += result.Elapsed;
+
+                global::System.Console.WriteLine("{0}: {1:#,0} headers, {2:#,0} invalid, {3:#,0} headers/s, {4:#,0.0} MB/s",
+                    path, result.Headers, result.Invalid.Count, result.HeadersPerSecond, result.BytesPerSecond / 1000000);
+                foreach (var offset in result.Invalid.Take(10))
+                    global::System.Console.WriteLine("  invalid header at offset {0}", offset);
+            }
+
+            if (elapsed > TimeSpan.Zero)
+                global::System.Console.WriteLine("Total: {0:#,0} headers, {1:#,0} invalid, {2:#,0} headers/s, {3:#,0.0} MB/s",
+                    headers, invalid, headers / elapsed.TotalSeconds, bytes / elapsed.TotalSeconds / 1000000);
+
+            return invalid > 0 ? 1 : 0;
         }
 
         private static void TimerCallback(object state)
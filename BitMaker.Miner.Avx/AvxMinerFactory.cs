@@ -1,4 +1,5 @@
 ﻿using System.Collections.Generic;
+using System.ComponentModel.Composition;
 using System.Linq;
 
 using BitMaker.Miner.Cpu;
@@ -10,7 +11,7 @@ namespace BitMaker.Miner.Avx
     /// <summary>
     /// Factory for <see cref="AvxMiner"/>.
     /// </summary>
-    [MinerFactory]
+    [MinerFactory(Device = MinerDeviceKind.Cpu, Requires = InstructionSet.Avx, Priority = 2)]
     public class AvxMinerFactory : CpuMinerFactory
     {
 
@@ -20,26 +21,35 @@ namespace BitMaker.Miner.Avx
         /// <returns></returns>
         static readonly bool hasAvx = AvxMinerUtils.Detect();
 
+        /// <summary>
+        /// Available miners.
+        /// </summary>
+        readonly IEnumerable<AvxMiner> miners;
+
         /// <summary>
         /// Gets the available resources to be allocated to miners.
         /// </summary>
-        public override IEnumerable<MinerResource> Resources
+        public override IEnumerable<MinerDevice> Devices
         {
-            get { return hasAvx ? base.Resources : Enumerable.Empty<MinerResource>(); }
+            get { return hasAvx ? base.Devices : Enumerable.Empty<MinerDevice>(); }
         }
 
         /// <summary>
-        /// Starts a new instance of the miner.
+        /// Initializes a new instance.
         /// </summary>
         /// <param name="context"></param>
-        /// <param name="resource"></param>
-        /// <returns></returns>
-        public override IMiner StartMiner(IMinerContext context, CpuResource resource)
+        [ImportingConstructor]
+        public AvxMinerFactory([Import] IMinerContext context)
         {
-            var miner = new AvxMiner(context, (CpuResource)resource);
-            miner.Start();
+            miners = Cpus
+                .Where(i => hasAvx)
+                .Select(i => new AvxMiner(context, i))
+                .ToList();
+        }
 
-            return miner;
+        public override IEnumerable<IMiner> Miners
+        {
+            get { return miners; }
         }
 
     }
@@ -2,10 +2,58 @@
 namespace BitMaker.Miner.Cpu
 {
 
+    /// <summary>
+    /// Represents a single logical processor in the system.
+    /// </summary>
     public class CpuDevice : MinerDevice
     {
 
+        volatile bool parked;
 
+        /// <summary>
+        /// Index of the logical processor, as used by the operating system for thread affinity.
+        /// </summary>
+        public int Index { get; set; }
+
+        /// <summary>
+        /// Physical package containing the processor.
+        /// </summary>
+        public int Package { get; set; }
+
+        /// <summary>
+        /// Physical core of the processor, unique across packages.
+        /// </summary>
+        public int Core { get; set; }
+
+        /// <summary>
+        /// Position of the processor amongst the hardware threads of its core, 0 for the first.
+        /// </summary>
+        public int CoreThread { get; set; }
+
+        /// <summary>
+        /// NUMA node the processor belongs to.
+        /// </summary>
+        public int NumaNode { get; set; }
+
+        /// <summary>
+        /// Lowest index of the processors sharing the L2 cache of the processor.
+        /// </summary>
+        public int L2Cache { get; set; }
+
+        /// <summary>
+        /// Indexes of the processors sharing the physical core, including this one.
+        /// </summary>
+        public int[] Siblings { get; set; }
+
+        /// <summary>
+        /// Gets whether the processor is outside of the limits of the process. Miners on a parked processor stop
+        /// searching and wait until it is released.
+        /// </summary>
+        public bool Parked
+        {
+            get { return parked; }
+            internal set { parked = value; }
+        }
 
     }
 
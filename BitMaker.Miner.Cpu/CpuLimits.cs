@@ -0,0 +1,159 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Threading;
+
+namespace BitMaker.Miner.Cpu
+{
+
+    /// <summary>
+    /// Sizes the set of running CPU miners to the processors and CPU time the process is allowed to use, as limited
+    /// by its affinity mask and cgroup quota. Limits are re-read periodically, parking and unparking devices as they
+    /// change.
+    /// </summary>
+    class CpuLimits : IDisposable
+    {
+
+        static readonly TimeSpan REFRESH_PERIOD = TimeSpan.FromSeconds(10);
+
+        /// <summary>
+        /// Devices in the order they are given processor time: the first hardware thread of every core, followed by
+        /// the second, and so on.
+        /// </summary>
+        readonly CpuDevice[] cpus;
+
+        /// <summary>
+        /// Timer that fires to re-read the limits.
+        /// </summary>
+        readonly Timer timer;
+
+        /// <summary>
+        /// Number of devices allowed to run after the previous refresh.
+        /// </summary>
+        int workers = -1;
+
+        /// <summary>
+        /// Initializes a new instance.
+        /// </summary>
+        /// <param name="cpus"></param>
+        public CpuLimits(IEnumerable<CpuDevice> cpus)
+        {
+            this.cpus = cpus
+                .OrderBy(i => i.CoreThread)
+                .ThenBy(i => i.Index)
+                .ToArray();
+
+            Refresh();
+            timer = new Timer(i => Refresh(), null, REFRESH_PERIOD, REFRESH_PERIOD);
+        }
+
+        /// <summary>
+        /// Re-reads the limits and parks the devices beyond them.
+        /// </summary>
+        void Refresh()
+        {
+            var allowed = CpuTopology.GetAllowedProcessors();
+            var available = cpus
+                .Where(i => allowed == null || allowed.Contains(i.Index))
+                .ToList();
+
+            // run no more threads than whole processors worth of quota, but always at least one
+            var quota = GetQuota();
+            var count = quota == null ? available.Count : Math.Max(1, Math.Min(available.Count, (int)Math.Floor((double)quota)));
+
+            var active = new HashSet<CpuDevice>(available.Take(count));
+            foreach (var cpu in cpus)
+                cpu.Parked = !active.Contains(cpu);
+
+            if (Interlocked.Exchange(ref workers, count) != count)
+                Console.WriteLine("CPU     : {0} of {1} processors available{2}", count, cpus.Length,
+                    quota == null ? "" : string.Format(CultureInfo.InvariantCulture, ", quota {0:0.##}", quota));
+        }
+
+        /// <summary>
+        /// Gets the number of processors worth of CPU time the cgroup of the process may use, or <c>null</c> if it is
+        /// not limited.
+        /// </summary>
+        /// <returns></returns>
+        static double? GetQuota()
+        {
+            try
+            {
+                foreach (var path in GetCgroupPaths())
+                {
+                    // cgroup v2: "<quota> <period>", or "max <period>"
+                    var cpuMax = Path.Combine(path, "cpu.max");
+                    if (File.Exists(cpuMax))
+                    {
+                        var values = File.ReadAllText(cpuMax).Trim().Split(' ');
+                        if (values[0] == "max")
+                            return null;
+
+                        return double.Parse(values[0], CultureInfo.InvariantCulture) / double.Parse(values[1], CultureInfo.InvariantCulture);
+                    }
+
+                    // cgroup v1: quota of -1 is unlimited
+                    var quota = Path.Combine(path, "cpu.cfs_quota_us");
+                    var period = Path.Combine(path, "cpu.cfs_period_us");
+                    if (File.Exists(quota) && File.Exists(period))
+                    {
+                        var q = double.Parse(File.ReadAllText(quota).Trim(), CultureInfo.InvariantCulture);
+                        if (q <= 0)
+                            return null;
+
+                        return q / double.Parse(File.ReadAllText(period).Trim(), CultureInfo.InvariantCulture);
+                    }
+                }
+            }
+            catch (Exception)
+            {
+                // limits are unknown
+            }
+
+            return null;
+        }
+
+        /// <summary>
+        /// Gets the directories which may hold the CPU controller of the cgroup of the process, most specific first.
+        /// </summary>
+        /// <returns></returns>
+        static IEnumerable<string> GetCgroupPaths()
+        {
+            if (!File.Exists("/proc/self/cgroup"))
+                yield break;
+
+            // lines are "<id>:<controllers>:<path>", controllers are empty for cgroup v2
+            foreach (var line in File.ReadAllLines("/proc/self/cgroup"))
+            {
+                var fields = line.Split(new[] { ':' }, 3);
+                if (fields.Length != 3)
+                    continue;
+
+                var path = fields[2].TrimStart('/');
+                if (fields[1] == "")
+                    yield return Path.Combine("/sys/fs/cgroup", path);
+                else if (fields[1].Split(',').Contains("cpu"))
+                {
+                    yield return Path.Combine("/sys/fs/cgroup/" + fields[1], path);
+                    yield return Path.Combine("/sys/fs/cgroup/cpu", path);
+                }
+            }
+
+            // within a container the cgroup is mounted at the root
+            yield return "/sys/fs/cgroup";
+            yield return "/sys/fs/cgroup/cpu";
+        }
+
+        /// <summary>
+        /// Stops monitoring the limits.
+        /// </summary>
+        public void Dispose()
+        {
+            timer.Dispose();
+        }
+
+    }
+
+}
@@ -1,4 +1,5 @@
 ﻿using System;
+using System.Collections.Generic;
 using System.ComponentModel.Composition;
 using System.Threading;
 using BitMaker.Utils;
@@ -50,6 +51,31 @@ namespace BitMaker.Miner.Cpu
         /// </summary>
         Thread workThread;
 
+        /// <summary>
+        /// Native buffers of the work thread, one descriptor reused for every work item.
+        /// </summary>
+        WorkArena arena;
+
+        /// <summary>
+        /// Work items searched together, reused for every search.
+        /// </summary>
+        Work[] packedWorks;
+
+        /// <summary>
+        /// Remainders of work items which were longer than those they were searched together with, searched before any
+        /// new work is requested.
+        /// </summary>
+        readonly Queue<Work> pendingWorks = new Queue<Work>();
+
+        /// <summary>
+        /// Gets the number of work items searched together, one per group of vector lanes. Miners which return more
+        /// than one implement <see cref="M:Search(Work[], uint*, byte*, out int)"/>.
+        /// </summary>
+        public virtual int PackedWorkCount
+        {
+            get { return 1; }
+        }
+
         /// <summary>
         /// Initializes a new instance.
         /// </summary>
@@ -113,53 +139,123 @@ namespace BitMaker.Miner.Cpu
         /// </summary>
         void WorkThread()
         {
+            // keep the thread on its processor, buffers allocated by it are then placed on the local NUMA node
+            Thread.BeginThreadAffinity();
+            var bound = CpuTopology.SetThreadAffinity(Cpu.Index);
+
+            arena = new WorkArena(1);
+            packedWorks = new Work[PackedWorkCount];
+
+            // placement is by first touch, which a memory policy of the process can override
+            if (bound && arena.Node >= 0 && arena.Node != Cpu.NumaNode)
+                Console.WriteLine("CPU     : {0} work buffers placed on NUMA node {1}, not local node {2}", Cpu.Id, arena.Node, Cpu.NumaNode);
+
             try
             {
                 // continue working until canceled
                 while (!cts.IsCancellationRequested)
-                    Work(Context.GetWork(this, GetType().Name));
+                {
+                    // wait while our processor is outside the limits of the process
+                    if (Cpu.Parked)
+                    {
+                        cts.Token.WaitHandle.WaitOne(1000);
+                        continue;
+                    }
+
+                    // a processor outside the affinity mask at start can only be bound once the mask grows to include it
+                    if (!bound)
+                        bound = CpuTopology.SetThreadAffinity(Cpu.Index);
+
+                    if (PackedWorkCount > 1)
+                        Work(GetPackedWork());
+                    else
+                        Work(Context.GetWork(this, GetType().Name));
+                }
             }
             catch (OperationCanceledException)
             {
                 // ignore
             }
+            finally
+            {
+                arena.Dispose();
+                arena = null;
+                packedWorks = null;
+
+                Thread.EndThreadAffinity();
+            }
         }
 
         /// <summary>
-        /// Prepares the buffers for processing a work item.
+        /// Gets as many work items as are searched together, each over the same number of nonces, or <c>null</c> if
+        /// no more work is available. The host hands out portions of different sizes, so the remainder of any longer
+        /// work is kept back and searched with the next set.
         /// </summary>
-        /// <param name="work"></param>
-        /// <param name="round1Blocks"></param>
-        /// <param name="round1State"></param>
-        /// <param name="round2Blocks"></param>
-        /// <param name="round2State"></param>
-        unsafe void PrepareWork(Work work, out byte[] round1Blocks, out uint[] round1State, out byte[] round2Blocks, out uint[] round2State)
+        /// <returns></returns>
+        Work[] GetPackedWork()
         {
-            // allocate buffers to hold hashing work
-            round1Blocks = Sha256.AllocateInputBuffer(80);
-            round1State = Sha256.AllocateStateBuffer();
-            round2Blocks = Sha256.AllocateInputBuffer(Sha256.SHA256_HASH_SIZE);
-            round2State = Sha256.AllocateStateBuffer();
-
-            fixed (byte* round1BlocksPtr = round1Blocks, round2BlocksPtr = round2Blocks)
-            fixed (uint* round1StatePtr = round1State, round2StatePtr = round2State)
+            var count = long.MaxValue;
+
+            for (int i = 0; i < packedWorks.Length; i++)
             {
-                // header arrives in big endian, convert to host
-                fixed (byte* workHeaderPtr = work.Header)
-                    Memory.ReverseEndian((uint*)workHeaderPtr, (uint*)round1BlocksPtr, 20);
+                if ((packedWorks[i] = GetPendingWork() ?? Context.GetWork(this, GetType().Name)) == null)
+                {
+                    // keep the work already obtained for when the miner resumes
+                    for (int j = 0; j < i; j++)
+                        pendingWorks.Enqueue(packedWorks[j]);
 
-                // append '1' bit and trailing length
-                Sha256.Prepare(round1BlocksPtr, 80, 0);
-                Sha256.Prepare(round1BlocksPtr + Sha256.SHA256_BLOCK_SIZE, 80, 1);
+                    return null;
+                }
 
-                // hash first half of header
-                Sha256.Initialize(round1StatePtr);
-                Sha256.Transform(round1StatePtr, round1BlocksPtr);
+                count = Math.Min(count, packedWorks[i].NonceCount);
+            }
 
-                // initialize values for round 2
-                Sha256.Initialize(round2StatePtr);
-                Sha256.Prepare(round2BlocksPtr, Sha256.SHA256_HASH_SIZE, 0);
+            // split off the nonces past the shortest range
+            for (int i = 0; i < packedWorks.Length; i++)
+                if (packedWorks[i].NonceCount > count)
+                {
+                    var work = packedWorks[i];
+                    pendingWorks.Enqueue(work.Split((uint)(work.NonceStart + count), work.NonceCount - count));
+                    work.NonceCount = count;
+                }
+
+            return packedWorks;
+        }
+
+        /// <summary>
+        /// Gets the next remainder of an earlier work item that is still current, or <c>null</c>.
+        /// </summary>
+        /// <returns></returns>
+        Work GetPendingWork()
+        {
+            while (pendingWorks.Count > 0)
+            {
+                var work = pendingWorks.Dequeue();
+                if (!work.IsStale)
+                    return work;
             }
+
+            return null;
+        }
+
+        /// <summary>
+        /// Prepares the buffers of <paramref name="descriptor"/> for processing a work item.
+        /// </summary>
+        /// <param name="work"></param>
+        /// <param name="descriptor"></param>
+        unsafe void PrepareWork(Work work, WorkDescriptor* descriptor)
+        {
+            // header arrives in big endian, convert to host
+            fixed (byte* workHeaderPtr = work.Header)
+                Memory.ReverseEndian((uint*)workHeaderPtr, (uint*)descriptor->Round1Blocks, 20);
+
+            // append '1' bit and trailing length
+            Sha256.Prepare(descriptor->Round1Blocks, 80, 0);
+            Sha256.Prepare(descriptor->Round1Blocks + Sha256.SHA256_BLOCK_SIZE, 80, 1);
+
+            // hash first half of header
+            Sha256.Initialize(descriptor->Round1State);
+            Sha256.Transform(descriptor->Round1State, descriptor->Round1Blocks);
         }
 
         /// <summary>
@@ -168,29 +264,61 @@ namespace BitMaker.Miner.Cpu
         /// <param name="work"></param>
         unsafe void Work(Work work)
         {
-            // allocate buffers to hold hashing work
-            byte[] round1Blocks, round2Blocks;
-            uint[] round1State, round2State;
+            // no work is available, the miner is being stopped
+            if (work == null)
+                return;
 
-            // allocate buffers
-            PrepareWork(work, out round1Blocks, out round1State, out round2Blocks, out round2State);
+            var descriptor = arena[0];
+            PrepareWork(work, descriptor);
 
             // search for nonce value
-            uint? nonce;
-            fixed (byte* round1BlocksPtr = round1Blocks, round2BlocksPtr = round2Blocks)
-            fixed (uint* round1StatePtr = round1State, round2StatePtr = round2State)
-                nonce = Search(work, round1StatePtr, round1BlocksPtr + Sha256.SHA256_BLOCK_SIZE, round2StatePtr, round2BlocksPtr);
+            var nonce = Search(work, descriptor->Round1State, descriptor->Round1Blocks + Sha256.SHA256_BLOCK_SIZE);
 
             // solution found!
             if (nonce != null)
-            {
-                // replace header data on work
-                fixed (byte* headerPtr = work.Header)
-                    ((uint*)headerPtr)[19] = Memory.ReverseEndian((uint)nonce);
+                Submit(work, (uint)nonce);
+        }
 
-                // let the caller know
-                Context.SubmitWork(this, work, GetType().Name);
+        /// <summary>
+        /// Attempts to solve the given work items together with the specified solver.
+        /// </summary>
+        /// <param name="works"></param>
+        unsafe void Work(Work[] works)
+        {
+            if (works == null)
+                return;
+
+            // round 1 state and block 2 of each work item, one after another
+            var descriptor = arena[0];
+            for (int i = 0; i < works.Length; i++)
+            {
+                PrepareWork(works[i], descriptor);
+                Memory.Copy(descriptor->Round1State, descriptor->Round1States + i * Sha256.SHA256_STATE_SIZE, Sha256.SHA256_STATE_SIZE);
+                Memory.Copy(descriptor->Round1Blocks + Sha256.SHA256_BLOCK_SIZE, descriptor->Round1Blocks2 + i * Sha256.SHA256_BLOCK_SIZE, Sha256.SHA256_BLOCK_SIZE);
             }
+
+            // search for nonce value
+            int index;
+            var nonce = Search(works, descriptor->Round1States, descriptor->Round1Blocks2, out index);
+
+            // solution found!
+            if (nonce != null)
+                Submit(works[index], (uint)nonce);
+        }
+
+        /// <summary>
+        /// Writes the nonce of a solution into the work header and submits it.
+        /// </summary>
+        /// <param name="work"></param>
+        /// <param name="nonce"></param>
+        unsafe void Submit(Work work, uint nonce)
+        {
+            // replace header data on work
+            fixed (byte* headerPtr = work.Header)
+                ((uint*)headerPtr)[19] = Memory.ReverseEndian(nonce);
+
+            // let the caller know
+            Context.SubmitWork(this, work, GetType().Name);
         }
 
         /// <summary>
@@ -200,10 +328,23 @@ namespace BitMaker.Miner.Cpu
         /// <param name="work"></param>
         /// <param name="round1State"></param>
         /// <param name="round1Block2"></param>
-        /// <param name="round2State"></param>
-        /// <param name="round2Block1"></param>
         /// <returns></returns>
-        public abstract unsafe uint? Search(Work work, uint* round1State, byte* round1Block2, uint* round2State, byte* round2Block1);
+        public abstract unsafe uint? Search(Work work, uint* round1State, byte* round1Block2);
+
+        /// <summary>
+        /// Searches several work items at once for a nonce solution, and returns it along with the index of the work
+        /// it solves. Round 1 states and blocks of the work items are laid out one after another, and every work item
+        /// has the same <see cref="P:Work.NonceCount"/>. If no solution is found, returns <c>null</c>.
+        /// </summary>
+        /// <param name="works"></param>
+        /// <param name="round1States"></param>
+        /// <param name="round1Blocks2"></param>
+        /// <param name="index"></param>
+        /// <returns></returns>
+        public virtual unsafe uint? Search(Work[] works, uint* round1States, byte* round1Blocks2, out int index)
+        {
+            throw new NotSupportedException();
+        }
 
     }
 
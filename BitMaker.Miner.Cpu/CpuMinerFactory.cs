@@ -15,25 +15,73 @@ namespace BitMaker.Miner.Cpu
         /// <summary>
         /// All available CPUs in the system.
         /// </summary>
-        static readonly IEnumerable<CpuDevice> cpus =
-            Enumerable.Range(0, Environment.ProcessorCount)
-            .Select(i => new CpuDevice() { Id = "CPU" + i })
-            .ToArray();
+        static readonly IEnumerable<CpuDevice> cpus = CpuTopology.Detect();
 
         /// <summary>
-        /// <see cref="T:CpuMiner"/> can consume all of the available processors in the system.
+        /// Parks CPUs beyond the quota of the process.
+        /// </summary>
+        static readonly CpuLimits limits = new CpuLimits(cpus);
+
+        /// <summary>
+        /// Returns the number of hardware threads of each core to run the miners of the given factory on, as
+        /// configured for the factory, or else for the section.
+        /// </summary>
+        /// <param name="type"></param>
+        /// <returns></returns>
+        static int GetThreadsPerCore(Type type)
+        {
+            var cfg = ConfigurationSection.GetDefaultSection();
+            var element = cfg.Miners.FirstOrDefault(i => i.Type == type);
+
+            return element != null && element.ThreadsPerCore >= 0 ? element.ThreadsPerCore : cfg.ThreadsPerCore;
+        }
+
+        /// <summary>
+        /// Configured number of hardware threads to use on each core.
+        /// </summary>
+        readonly int threadsPerCore;
+
+        /// <summary>
+        /// Initializes a new instance.
+        /// </summary>
+        protected CpuMinerFactory()
+        {
+            threadsPerCore = GetThreadsPerCore(GetType());
+        }
+
+        /// <summary>
+        /// Gets the number of hardware threads of each core to run miners on, or 0 for all of them. Set per factory,
+        /// so that wide kernels which saturate a core with a single thread can leave SMT siblings idle while others use
+        /// them.
+        /// </summary>
+        protected int ThreadsPerCore
+        {
+            get { return threadsPerCore; }
+        }
+
+        /// <summary>
+        /// <see cref="T:CpuMiner"/> can consume the available processors in the system, limited to
+        /// <see cref="P:ThreadsPerCore"/> on each core. The first hardware thread of every core comes first, so the
+        /// host brings cores into use before their siblings.
         /// </summary>
         public virtual IEnumerable<CpuDevice> Cpus
         {
-            get { return cpus; }
+            get
+            {
+                return cpus
+                    .Where(i => ThreadsPerCore <= 0 || i.CoreThread < ThreadsPerCore)
+                    .OrderBy(i => i.CoreThread)
+                    .ThenBy(i => i.Index);
+            }
         }
 
         /// <summary>
-        /// <see cref="T:CpuMiner"/> can consume all of the available processors in the system.
+        /// <see cref="T:CpuMiner"/> can consume the available processors in the system, limited to
+        /// <see cref="P:ThreadsPerCore"/> on each core.
         /// </summary>
         public virtual IEnumerable<MinerDevice> Devices
         {
-            get { return cpus; }
+            get { return Cpus; }
         }
 
         /// <summary>
@@ -0,0 +1,325 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Runtime.InteropServices;
+
+namespace BitMaker.Miner.Cpu
+{
+
+    /// <summary>
+    /// Discovers the layout of the logical processors in the system, and binds threads to them.
+    /// </summary>
+    static class CpuTopology
+    {
+
+        const string SYSFS_CPU = "/sys/devices/system/cpu";
+
+        const int RelationProcessorCore = 0;
+        const int RelationNumaNode = 1;
+        const int RelationCache = 2;
+        const int RelationProcessorPackage = 3;
+
+        [StructLayout(LayoutKind.Explicit)]
+        struct SYSTEM_LOGICAL_PROCESSOR_INFORMATION_UNION
+        {
+
+            [FieldOffset(0)]
+            public byte CacheLevel;
+
+            [FieldOffset(0)]
+            public uint NodeNumber;
+
+            [FieldOffset(8)]
+            public ulong Reserved;
+
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        struct SYSTEM_LOGICAL_PROCESSOR_INFORMATION
+        {
+
+            public UIntPtr ProcessorMask;
+
+            public int Relationship;
+
+            public SYSTEM_LOGICAL_PROCESSOR_INFORMATION_UNION Union;
+
+        }
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        static extern bool GetLogicalProcessorInformation(IntPtr buffer, ref int returnLength);
+
+        [DllImport("kernel32.dll")]
+        static extern IntPtr GetCurrentThread();
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        static extern UIntPtr SetThreadAffinityMask(IntPtr thread, UIntPtr mask);
+
+        [DllImport("libc", SetLastError = true)]
+        static extern int sched_setaffinity(int pid, IntPtr size, byte[] mask);
+
+        /// <summary>
+        /// Gets whether we are running on a Unix-like system.
+        /// </summary>
+        static bool IsUnix
+        {
+            get { return Environment.OSVersion.Platform == PlatformID.Unix || Environment.OSVersion.Platform == PlatformID.MacOSX; }
+        }
+
+        /// <summary>
+        /// Returns a device for each logical processor which is online, including those outside the affinity mask of
+        /// the process, so that the mask may grow later; <see cref="T:CpuLimits"/> parks the devices outside it.
+        /// Processors brought online later are not seen without a restart. If the topology cannot be read, each
+        /// processor is reported as a core of its own.
+        /// </summary>
+        /// <returns></returns>
+        public static CpuDevice[] Detect()
+        {
+            var indexes = new HashSet<int>(GetOnlineProcessors() ?? Enumerable.Empty<int>());
+            indexes.UnionWith(GetAllowedProcessors() ?? Enumerable.Empty<int>());
+            if (indexes.Count == 0)
+                indexes.UnionWith(Enumerable.Range(0, Environment.ProcessorCount));
+
+            var cpus = indexes
+                .OrderBy(i => i)
+                .Select(i => new CpuDevice()
+                {
+                    Id = "CPU" + i,
+                    Index = i,
+                    Core = i,
+                    L2Cache = i,
+                })
+                .ToArray();
+
+            try
+            {
+                if (IsUnix)
+                    ReadSysfs(cpus);
+                else
+                    ReadLogicalProcessorInformation(cpus);
+            }
+            catch (Exception)
+            {
+                // fall back to a flat layout
+                foreach (var cpu in cpus)
+                {
+                    cpu.Package = 0;
+                    cpu.Core = cpu.Index;
+                    cpu.NumaNode = 0;
+                    cpu.L2Cache = cpu.Index;
+                }
+            }
+
+            // derive siblings and thread positions from the cores
+            foreach (var core in cpus.GroupBy(i => i.Core))
+            {
+                var siblings = core
+                    .OrderBy(i => i.Index)
+                    .ToArray();
+
+                for (int i = 0; i < siblings.Length; i++)
+                {
+                    siblings[i].CoreThread = i;
+                    siblings[i].Siblings = siblings.Select(j => j.Index).ToArray();
+                }
+            }
+
+            return cpus;
+        }
+
+        /// <summary>
+        /// Gets the indexes of the logical processors which are online, whether or not the process may run on them.
+        /// Returns <c>null</c> if they cannot be read.
+        /// </summary>
+        /// <returns></returns>
+        static ICollection<int> GetOnlineProcessors()
+        {
+            try
+            {
+                if (IsUnix)
+                    return new HashSet<int>(ParseList(File.ReadAllText(Path.Combine(SYSFS_CPU, "online"))));
+
+                // only the first processor group can be described
+                return new HashSet<int>(Enumerable.Range(0, Math.Min(Environment.ProcessorCount, IntPtr.Size * 8)));
+            }
+            catch (Exception)
+            {
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Gets the indexes of the logical processors in the affinity mask of the process, which includes the cpuset
+        /// of its cgroup. Returns <c>null</c> if the mask cannot be read.
+        /// </summary>
+        /// <returns></returns>
+        public static ICollection<int> GetAllowedProcessors()
+        {
+            try
+            {
+                if (IsUnix)
+                {
+                    var line = File.ReadAllLines("/proc/self/status")
+                        .FirstOrDefault(i => i.StartsWith("Cpus_allowed_list:"));
+                    if (line == null)
+                        return null;
+
+                    return new HashSet<int>(ParseList(line.Substring(line.IndexOf(':') + 1)));
+                }
+
+                var mask = (ulong)Process.GetCurrentProcess().ProcessorAffinity.ToInt64();
+                return new HashSet<int>(Enumerable.Range(0, IntPtr.Size * 8).Where(i => (mask & (1UL << i)) != 0));
+            }
+            catch (Exception)
+            {
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Parses a sysfs cpu list, such as "0-3,8".
+        /// </summary>
+        /// <param name="list"></param>
+        /// <returns></returns>
+        static IEnumerable<int> ParseList(string list)
+        {
+            foreach (var range in list.Trim().Split(new[] { ',' }, StringSplitOptions.RemoveEmptyEntries))
+            {
+                var bounds = range.Split('-');
+                var first = int.Parse(bounds[0]);
+                var last = bounds.Length > 1 ? int.Parse(bounds[1]) : first;
+                for (int i = first; i <= last; i++)
+                    yield return i;
+            }
+        }
+
+        /// <summary>
+        /// Reads the topology of the processors from sysfs.
+        /// </summary>
+        /// <param name="cpus"></param>
+        static void ReadSysfs(CpuDevice[] cpus)
+        {
+            // core ids are only unique within a package
+            var cores = new Dictionary<Tuple<int, int>, int>();
+
+            foreach (var cpu in cpus)
+            {
+                var path = Path.Combine(SYSFS_CPU, "cpu" + cpu.Index);
+                var package = int.Parse(File.ReadAllText(Path.Combine(path, "topology/physical_package_id")).Trim());
+                var core = int.Parse(File.ReadAllText(Path.Combine(path, "topology/core_id")).Trim());
+
+                int id;
+                if (!cores.TryGetValue(Tuple.Create(package, core), out id))
+                    cores[Tuple.Create(package, core)] = id = cores.Count;
+
+                cpu.Package = package;
+                cpu.Core = id;
+
+                // node is exposed as a nodeN link within the cpu directory
+                var node = Directory.GetDirectories(path, "node*")
+                    .Select(i => Path.GetFileName(i).Substring(4))
+                    .Select(i => { int n; return int.TryParse(i, out n) ? n : -1; })
+                    .FirstOrDefault(i => i >= 0);
+                cpu.NumaNode = node;
+
+                // level 2 cache, identified by the lowest processor that shares it
+                var cache = Path.Combine(path, "cache");
+                if (Directory.Exists(cache))
+                    foreach (var index in Directory.GetDirectories(cache, "index*"))
+                        if (File.ReadAllText(Path.Combine(index, "level")).Trim() == "2")
+                            cpu.L2Cache = ParseList(File.ReadAllText(Path.Combine(index, "shared_cpu_list"))).Min();
+            }
+        }
+
+        /// <summary>
+        /// Reads the topology of the processors from GetLogicalProcessorInformation. Only the first 64 processors can
+        /// be described.
+        /// </summary>
+        /// <param name="cpus"></param>
+        static void ReadLogicalProcessorInformation(CpuDevice[] cpus)
+        {
+            var length = 0;
+            GetLogicalProcessorInformation(IntPtr.Zero, ref length);
+
+            var buffer = Marshal.AllocHGlobal(length);
+            try
+            {
+                if (!GetLogicalProcessorInformation(buffer, ref length))
+                    throw new InvalidOperationException("GetLogicalProcessorInformation failed.");
+
+                var size = Marshal.SizeOf(typeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+                var core = 0;
+                var package = 0;
+
+                for (int offset = 0; offset + size <= length; offset += size)
+                {
+                    var info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION)Marshal.PtrToStructure(buffer + offset, typeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+                    var mask = info.ProcessorMask.ToUInt64();
+                    var members = cpus.Where(i => i.Index < 64 && (mask & (1UL << i.Index)) != 0).ToList();
+                    if (members.Count == 0)
+                        continue;
+
+                    switch (info.Relationship)
+                    {
+                        case RelationProcessorCore:
+                            members.ForEach(i => i.Core = core);
+                            core++;
+                            break;
+                        case RelationProcessorPackage:
+                            members.ForEach(i => i.Package = package);
+                            package++;
+                            break;
+                        case RelationNumaNode:
+                            members.ForEach(i => i.NumaNode = (int)info.Union.NodeNumber);
+                            break;
+                        case RelationCache:
+                            if (info.Union.CacheLevel == 2)
+                                members.ForEach(i => i.L2Cache = members.Min(j => j.Index));
+                            break;
+                    }
+                }
+
+                // processors beyond the first 64 are not described, keep their cores distinct
+                foreach (var cpu in cpus.Where(i => i.Index >= 64))
+                    cpu.Core = core++;
+            }
+            finally
+            {
+                Marshal.FreeHGlobal(buffer);
+            }
+        }
+
+        /// <summary>
+        /// Binds the calling thread to the given logical processor. Returns <c>false</c> if the operating system
+        /// refused.
+        /// </summary>
+        /// <param name="index"></param>
+        /// <returns></returns>
+        public static bool SetThreadAffinity(int index)
+        {
+            try
+            {
+                if (IsUnix)
+                {
+                    // pid 0 refers to the calling thread
+                    var mask = new byte[Math.Max(128, index / 8 + 1)];
+                    mask[index / 8] = (byte)(1 << (index % 8));
+                    return sched_setaffinity(0, (IntPtr)mask.Length, mask) == 0;
+                }
+
+                if (index >= IntPtr.Size * 8)
+                    return false;
+
+                return SetThreadAffinityMask(GetCurrentThread(), (UIntPtr)(1UL << index)) != UIntPtr.Zero;
+            }
+            catch (Exception)
+            {
+                return false;
+            }
+        }
+
+    }
+
+}
@@ -1,5 +1,12 @@
 typedef uint z;
 
+#pragma OPENCL EXTENSION cl_khr_global_int32_base_atomics : enable
+
+// number of result slots following the count in the output buffer
+#ifndef OUTPUT_CAPACITY
+#define OUTPUT_CAPACITY 63
+#endif
+
 #if BITALIGN
 #pragma OPENCL EXTENSION cl_amd_media_ops : enable
 #define Zrotr(a, b) amd_bitalign((z)a, (z)a, (z)(32 - b))
@@ -1217,7 +1224,9 @@ __kernel __attribute__((reqd_work_group_size(WORKSIZE, 1, 1))) void search(
 
 	nonce = (io) ? Znonce : nonce;
 
-	if(io) { output[0] = (uintzz)nonce; }
+	// claim the next slot after the count, which the host polls to learn whether to read anything back; the count
+	// keeps going past the capacity, so the host learns of results that did not fit and searches the range again
+	if(io) { uint slot = atomic_inc(&output[0]); if(slot < OUTPUT_CAPACITY) { output[1 + slot] = (uintzz)nonce; } }
 }
 
 // vim: set ft=c
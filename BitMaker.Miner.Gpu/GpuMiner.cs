@@ -62,6 +62,45 @@ namespace BitMaker.Miner.Gpu
         ComputeBuffer<uint> clBuffer0;
         ComputeBuffer<uint> clBuffer1;
 
+        /// <summary>
+        /// Layout of the kernel output buffers: a count of the nonces found, which doubles as the flag polled by the
+        /// host, followed by the nonces themselves in the order the work items claimed their slots.
+        /// </summary>
+        const int OUTPUT_COUNT = 0;
+        const int OUTPUT_NONCES = 1;
+
+        /// <summary>
+        /// Number of nonce slots in each output buffer. The kernel keeps counting past it, so a dispatch which found
+        /// more is detected and its range searched again in smaller pieces.
+        /// </summary>
+        const int OUTPUT_CAPACITY = 63;
+
+        /// <summary>
+        /// Start and size of the range last dispatched into each output buffer.
+        /// </summary>
+        readonly uint[] outputStart = new uint[2];
+        readonly long[] outputSize = new long[2];
+
+        /// <summary>
+        /// Native buffers of the work thread, one descriptor reused for every work item.
+        /// </summary>
+        WorkArena arena;
+
+        /// <summary>
+        /// Dispatch dimensions, reused for every dispatch.
+        /// </summary>
+        readonly long[] globalWorkOffset = new long[1];
+        readonly long[] globalWorkSize = new long[1];
+        readonly long[] localWorkSize = new long[1];
+
+        /// <summary>
+        /// Gets the largest number of nonces dispatched to the GPU at a time.
+        /// </summary>
+        long MaxWorkSize
+        {
+            get { return (long)Gpu.WorkSize * Gpu.WorkSize * 8; }
+        }
+
         /// <summary>
         /// Initializes a new instance.
         /// </summary>
@@ -140,6 +179,9 @@ namespace BitMaker.Miner.Gpu
 
             clQueue.Finish();
 
+            arena.Dispose();
+            arena = null;
+
             clKernel.Dispose();
             clKernel = null;
 
@@ -162,40 +204,23 @@ namespace BitMaker.Miner.Gpu
         }
 
         /// <summary>
-        /// Prepares the buffers for processing a work item.
+        /// Prepares the buffers of <paramref name="descriptor"/> for processing a work item.
         /// </summary>
         /// <param name="work"></param>
-        /// <param name="round1Blocks"></param>
-        /// <param name="round1State"></param>
-        /// <param name="round2Blocks"></param>
-        /// <param name="round2State"></param>
-        unsafe void PrepareWork(Work work, out byte[] round1Blocks, out uint[] round1State, out byte[] round2Blocks, out uint[] round2State)
+        /// <param name="descriptor"></param>
+        unsafe void PrepareWork(Work work, WorkDescriptor* descriptor)
         {
-            // allocate buffers to hold hashing work
-            round1Blocks = Sha256.AllocateInputBuffer(80);
-            round1State = Sha256.AllocateStateBuffer();
-            round2Blocks = Sha256.AllocateInputBuffer(Sha256.SHA256_HASH_SIZE);
-            round2State = Sha256.AllocateStateBuffer();
-
-            fixed (byte* round1BlocksPtr = round1Blocks, round2BlocksPtr = round2Blocks)
-            fixed (uint* round1StatePtr = round1State, round2StatePtr = round2State)
-            {
-                // header arrives in big endian, convert to host
-                fixed (byte* workHeaderPtr = work.Header)
-                    Memory.ReverseEndian((uint*)workHeaderPtr, (uint*)round1BlocksPtr, 20);
-
-                // append '1' bit and trailing length
-                Sha256.Prepare(round1BlocksPtr, 80, 0);
-                Sha256.Prepare(round1BlocksPtr + Sha256.SHA256_BLOCK_SIZE, 80, 1);
+            // header arrives in big endian, convert to host
+            fixed (byte* workHeaderPtr = work.Header)
+                Memory.ReverseEndian((uint*)workHeaderPtr, (uint*)descriptor->Round1Blocks, 20);
 
-                // hash first half of header
-                Sha256.Initialize(round1StatePtr);
-                Sha256.Transform(round1StatePtr, round1BlocksPtr);
+            // append '1' bit and trailing length
+            Sha256.Prepare(descriptor->Round1Blocks, 80, 0);
+            Sha256.Prepare(descriptor->Round1Blocks + Sha256.SHA256_BLOCK_SIZE, 80, 1);
 
-                // initialize values for round 2
-                Sha256.Initialize(round2StatePtr);
-                Sha256.Prepare(round2BlocksPtr, Sha256.SHA256_HASH_SIZE, 0);
-            }
+            // hash first half of header
+            Sha256.Initialize(descriptor->Round1State);
+            Sha256.Transform(descriptor->Round1State, descriptor->Round1Blocks);
         }
 
         /// <summary>
@@ -224,9 +249,10 @@ namespace BitMaker.Miner.Gpu
                 // queue to control device
                 clQueue = new ComputeCommandQueue(clContext, clDevice, ComputeCommandQueueFlags.None);
 
-                // buffers to store kernel output
-                clBuffer0 = new ComputeBuffer<uint>(clContext, ComputeMemoryFlags.ReadOnly, 16);
-                clBuffer1 = new ComputeBuffer<uint>(clContext, ComputeMemoryFlags.ReadOnly, 16);
+                // buffers to store kernel output, placed in host memory where the device allows, so that polling the
+                // count is a zero-copy read
+                clBuffer0 = new ComputeBuffer<uint>(clContext, ComputeMemoryFlags.ReadWrite | ComputeMemoryFlags.AllocateHostPointer, OUTPUT_NONCES + OUTPUT_CAPACITY);
+                clBuffer1 = new ComputeBuffer<uint>(clContext, ComputeMemoryFlags.ReadWrite | ComputeMemoryFlags.AllocateHostPointer, OUTPUT_NONCES + OUTPUT_CAPACITY);
 
                 // obtain the program
                 clProgram = new ComputeProgram(clContext, Gpu.GetSource());
@@ -234,6 +260,7 @@ namespace BitMaker.Miner.Gpu
                 var b = new StringBuilder();
                 if (Gpu.WorkSize > 0)
                     b.Append(" -D WORKSIZE=").Append(Gpu.WorkSize);
+                b.Append(" -D OUTPUT_CAPACITY=").Append(OUTPUT_CAPACITY);
                 if (Gpu.HasBitAlign)
                     b.Append(" -D BITALIGN");
                 if (Gpu.HasBfiInt)
@@ -250,6 +277,9 @@ namespace BitMaker.Miner.Gpu
                 }
 
                 clKernel = clProgram.CreateKernel("search");
+
+                // native buffers, owned by the thread which works on the device
+                arena = new WorkArena(1);
             }
             finally
             {
@@ -270,7 +300,7 @@ namespace BitMaker.Miner.Gpu
 
             // abort if we are working on stale work, or if instructed to
             return
-                work.Pool.CurrentBlockNumber == work.BlockNumber &&
+                !work.IsStale &&
                 !CancellationToken.IsCancellationRequested;
         }
 
@@ -281,21 +311,22 @@ namespace BitMaker.Miner.Gpu
         /// <param name="work"></param>
         internal unsafe void Work(Work work)
         {
-            // allocate buffers to hold hashing work
-            byte[] round1Blocks, round2Blocks;
-            uint[] round1State, round1State2Mid, round2State;
+            // no work is available, the miner is being stopped
+            if (work == null)
+                return;
 
-            // allocate buffers and create partial hash
-            PrepareWork(work, out round1Blocks, out round1State, out round2Blocks, out round2State);
+            // create partial hash
+            var descriptor = arena[0];
+            PrepareWork(work, descriptor);
+            var round1State = descriptor->Round1State;
+            var round1State2Mid = descriptor->Midstate;
 
             // build message schedule without nonce
-            uint* W = stackalloc uint[64];
-            fixed (byte* round1BlocksPtr = round1Blocks)
-                Sha256.Schedule(round1BlocksPtr + Sha256.SHA256_BLOCK_SIZE, W);
+            var W = descriptor->Schedule;
+            Sha256.Schedule(descriptor->Round1Blocks + Sha256.SHA256_BLOCK_SIZE, W);
 
             // complete first three rounds of block 2
-            round1State2Mid = Sha256.AllocateStateBuffer();
-            Array.Copy(round1State, round1State2Mid, Sha256.SHA256_STATE_SIZE);
+            Memory.Copy(round1State, round1State2Mid, Sha256.SHA256_STATE_SIZE);
             Sha256.Round(ref round1State2Mid[0], ref round1State2Mid[1], ref round1State2Mid[2], ref round1State2Mid[3], ref round1State2Mid[4], ref round1State2Mid[5], ref round1State2Mid[6], ref round1State2Mid[7], W, 0);
             Sha256.Round(ref round1State2Mid[0], ref round1State2Mid[1], ref round1State2Mid[2], ref round1State2Mid[3], ref round1State2Mid[4], ref round1State2Mid[5], ref round1State2Mid[6], ref round1State2Mid[7], W, 1);
             Sha256.Round(ref round1State2Mid[0], ref round1State2Mid[1], ref round1State2Mid[2], ref round1State2Mid[3], ref round1State2Mid[4], ref round1State2Mid[5], ref round1State2Mid[6], ref round1State2Mid[7], W, 2);
@@ -318,50 +349,28 @@ namespace BitMaker.Miner.Gpu
             uint W17_plus_K17 = (uint)(W17 + Sha256.K[17]);
 
             // clear output buffers, in case they've already been used
-            uint[] outputZero = new uint[16];
-            clQueue.WriteToBuffer(outputZero, clBuffer0, true, null);
-            clQueue.WriteToBuffer(outputZero, clBuffer1, true, null);
-
-            // to hold output buffer
-            uint[] output = new uint[16];
+            ResetOutput(clBuffer0);
+            ResetOutput(clBuffer1);
 
             // swaps between true and false to allow a kernel to execute while testing output of last run
             bool outputAlt = true;
 
             // size of local work groups
-            long localWorkSize = Gpu.WorkSize;
+            localWorkSize[0] = Gpu.WorkSize;
 
             // number of items to dispatch to GPU at a time
-            long globalWorkSize = localWorkSize * localWorkSize * 8;
+            long maxWorkSize = MaxWorkSize;
 
-            // begin working at 0
-            uint nonce = 0;
+            // begin working at the start of the range
+            uint nonce = work.NonceStart;
+            long done = 0;
 
-            // continue dispatching work to the GPU
-            while (true)
+            // continue dispatching work to the GPU until the range is exhausted
+            while (done < work.NonceCount)
             {
                 // if one loop has completed
-                if (nonce > 0)
-                {
-                    // read output into current output buffer then reset buffer
-                    clQueue.ReadFromBuffer(outputAlt ? clBuffer0 : clBuffer1, ref output, true, null);
-
-                    // scan output buffer for produced nonce values
-                    fixed (uint* o = output)
-                        for (int j = 0; j < 16; j++)
-                            if (o[j] != 0)
-                            {
-                                // replace header data on work
-                                fixed (byte* headerPtr = work.Header)
-                                    ((uint*)headerPtr)[19] = output[j];
-
-                                // submit work for validation
-                                Context.SubmitWork(this, work, GetType().Name);
-
-                                // clear output buffer
-                                clQueue.WriteToBuffer(outputZero, outputAlt ? clBuffer0 : clBuffer1, true, null);
-                            }
-                }
+                if (done > 0)
+                    ReadOutput(work, outputAlt ? 0 : 1);
 
                 // execute kernel with computed values
                 clQueue.Finish();
@@ -392,20 +401,143 @@ namespace BitMaker.Miner.Gpu
                 clKernel.SetValueArgument(24, round1State[5]);
                 clKernel.SetValueArgument(25, round1State[6]);
                 clKernel.SetValueArgument(26, round1State[7]);
-                clKernel.SetMemoryArgument(27, outputAlt ? clBuffer0 : clBuffer1);
-                clQueue.Execute(clKernel, null, new long[] { globalWorkSize }, new long[] { localWorkSize }, null);
 
-                // report that we just hashed the work size number of hashes
-                if (!Progress(work, globalWorkSize))
-                    break;
+                // dispatch no more than the rest of the range, in whole work groups, offset to the current nonce
+                long size = Math.Min(maxWorkSize, work.NonceCount - done);
+                size = (size + localWorkSize[0] - 1) / localWorkSize[0] * localWorkSize[0];
+                Dispatch(outputAlt ? 0 : 1, nonce, size);
 
-                // update nonce and check whether it is now less than the work size, which indicates it overflowed
-                if ((nonce += (uint)globalWorkSize) < (uint)globalWorkSize)
+                // report that we just hashed the dispatched number of hashes
+                if (!Progress(work, size))
                     break;
 
+                // advance through the range, wrapping around the end of the nonce space
+                nonce += (uint)size;
+                done += size;
+
                 // next loop deals with other output buffer
                 outputAlt = !outputAlt;
             }
+
+            // collect the output of the last two dispatches, also when told to stop, so that solutions of current work
+            // are submitted before the miner finishes stopping
+            clQueue.Finish();
+            if (work.IsStale)
+                return;
+
+            ReadOutput(work, outputAlt ? 0 : 1);
+            ReadOutput(work, outputAlt ? 1 : 0);
+        }
+
+        /// <summary>
+        /// Executes the kernel over <paramref name="size"/> nonces from <paramref name="start"/>, writing into the
+        /// output buffer at <paramref name="index"/>. The remaining kernel arguments must already be set.
+        /// </summary>
+        /// <param name="index"></param>
+        /// <param name="start"></param>
+        /// <param name="size"></param>
+        void Dispatch(int index, uint start, long size)
+        {
+            clKernel.SetMemoryArgument(27, index == 0 ? clBuffer0 : clBuffer1);
+            globalWorkOffset[0] = start;
+            globalWorkSize[0] = size;
+            clQueue.Execute(clKernel, globalWorkOffset, globalWorkSize, localWorkSize, null);
+
+            outputStart[index] = start;
+            outputSize[index] = size;
+        }
+
+        /// <summary>
+        /// Searches the range last dispatched into the output buffer at <paramref name="index"/> again, in two halves,
+        /// after it found more nonces than the buffer holds.
+        /// </summary>
+        /// <param name="work"></param>
+        /// <param name="index"></param>
+        void Rescan(Work work, int index)
+        {
+            var start = outputStart[index];
+            var size = outputSize[index];
+            var half = (size / 2 + localWorkSize[0] - 1) / localWorkSize[0] * localWorkSize[0];
+
+            Dispatch(index, start, half);
+            ReadOutput(work, index);
+
+            Dispatch(index, (uint)(start + half), size - half);
+            ReadOutput(work, index);
+        }
+
+        /// <summary>
+        /// Clears the count of nonces found in the given output buffer.
+        /// </summary>
+        /// <param name="buffer"></param>
+        unsafe void ResetOutput(ComputeBuffer<uint> buffer)
+        {
+            var count = clQueue.Map(buffer, true, ComputeMemoryMappingFlags.Write, OUTPUT_COUNT, 1, null);
+            *(uint*)count = 0;
+            clQueue.Unmap(buffer, ref count, null);
+        }
+
+        /// <summary>
+        /// Polls the count of nonces found in the output buffer at <paramref name="index"/>, and only if there are any
+        /// reads them back, submits them and resets the buffer. If more were found than the buffer holds, the range is
+        /// searched again instead.
+        /// </summary>
+        /// <param name="work"></param>
+        /// <param name="index"></param>
+        unsafe void ReadOutput(Work work, int index)
+        {
+            var buffer = index == 0 ? clBuffer0 : clBuffer1;
+            var overflow = false;
+
+            // the count is normally zero, in which case nothing else is transferred
+            var count = clQueue.Map(buffer, true, ComputeMemoryMappingFlags.Read | ComputeMemoryMappingFlags.Write, OUTPUT_COUNT, 1, null);
+
+            try
+            {
+                var found = *(uint*)count;
+                if (found == 0)
+                    return;
+
+                // nonces past the capacity were counted but not stored; search smaller pieces of the range until each
+                // fits, down to a single work group, whose stored nonces are taken as they are
+                if (found > OUTPUT_CAPACITY && outputSize[index] > localWorkSize[0])
+                {
+                    *(uint*)count = 0;
+                    overflow = true;
+                    return;
+                }
+
+                // read back only the slots claimed
+                found = Math.Min(found, OUTPUT_CAPACITY);
+                var nonces = clQueue.Map(buffer, true, ComputeMemoryMappingFlags.Read, OUTPUT_NONCES, found, null);
+
+                try
+                {
+                    for (int i = 0; i < found; i++)
+                    {
+                        // replace header data on work
+                        fixed (byte* headerPtr = work.Header)
+                            ((uint*)headerPtr)[19] = ((uint*)nonces)[i];
+
+                        // submit work for validation
+                        Context.SubmitWork(this, work, GetType().Name);
+                    }
+                }
+                finally
+                {
+                    clQueue.Unmap(buffer, ref nonces, null);
+                }
+
+                // reset buffer for its next dispatch
+                *(uint*)count = 0;
+            }
+            finally
+            {
+                clQueue.Unmap(buffer, ref count, null);
+            }
+
+            if (overflow)
+                Rescan(work, index);
         }
 
     }
@@ -8,7 +8,7 @@ using Cloo;
 namespace BitMaker.Miner.Gpu
 {
 
-    [MinerFactory]
+    [MinerFactory(Device = MinerDeviceKind.Gpu)]
     public sealed class GpuMinerFactory : IMinerFactory
     {
 
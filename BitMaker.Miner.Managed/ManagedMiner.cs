@@ -1,4 +1,5 @@
-﻿using System.Threading;
+﻿using System.Runtime.CompilerServices;
+using System.Threading;
 
 using BitMaker.Miner.Cpu;
 using BitMaker.Utils;
@@ -9,7 +10,7 @@ namespace BitMaker.Miner.Managed
     /// <summary>
     /// Completely managed C# implementation of a miner.
     /// </summary>
-    public class ManagedMiner : CpuMiner
+    public partial class ManagedMiner : CpuMiner
     {
 
         /// <summary>
@@ -34,10 +35,11 @@ namespace BitMaker.Miner.Managed
             // report hashes to context
             Context.ReportHashes(this, hashes);
 
-            // abort if we are working on stale work, or if instructed to
+            // abort if we are working on stale work, if instructed to, or if our processor is parked
             return 
-                work.Pool.CurrentBlockNumber == work.BlockNumber &&
-                !CancellationToken.IsCancellationRequested;
+                !work.IsStale &&
+                !CancellationToken.IsCancellationRequested &&
+                !Cpu.Parked;
         }
 
         /// <summary>
@@ -46,42 +48,562 @@ namespace BitMaker.Miner.Managed
         /// <param name="work"></param>
         /// <param name="round1State"></param>
         /// <param name="round1Block2"></param>
-        /// <param name="round2State"></param>
-        /// <param name="round2Block1"></param>
         /// <returns></returns>
-        public override unsafe uint? Search(Work work, uint* round1State, byte* round1Block2, uint* round2State, byte* round2Block1)
+        public override unsafe uint? Search(Work work, uint* round1State, byte* round1Block2)
         {
-            // starting nonce
-            uint nonce = 0;
+#if NET7_0_OR_GREATER
+            // several nonces at once, where the runtime accelerates vectors
+            if (System.Numerics.Vector.IsHardwareAccelerated)
+                return SearchVector(work, round1State, round1Block2);
+#endif
 
-            // output for final hash
-            uint* round2State2 = stackalloc uint[Sha256.SHA256_STATE_SIZE];
+            // starting nonce, and number of nonces searched so far
+            uint nonce = work.NonceStart;
+            long done = 0;
 
-            while (true)
-            {
-                // update the nonce value
-                ((uint*)round1Block2)[3] = nonce;
+            // values of round 1 block 2 which do not depend on the nonce, calculated once per work
+            uint* round1Mid = stackalloc uint[8];
+            uint* round1Pre = stackalloc uint[6];
+            Precalc(round1State, (uint*)round1Block2, round1Mid, round1Pre);
 
-                // transform variable second half of block using saved state from first block, into pre-padded round 2 block (end of first hash)
-                Sha256.Transform(round1State, round1Block2, (uint*)round2Block1);
+            // message schedules of both transforms, the first 8 words of the second receive the output of the first;
+            // the round 2 state and remainder of the block are constant and folded into TransformFinal
+            uint* round1W = stackalloc uint[64];
+            uint* round2W = stackalloc uint[64];
 
-                // transform round 2 block into round 2 state (second hash)
-                Sha256.Transform(round2State, round2Block1, round2State2);
+            while (true)
+            {
+                // transform variable second half of block using saved state from first block, into round 2 block (end of first hash)
+                TransformNonce(round1State, round1Mid, round1Pre, nonce, round1W, round2W);
 
-                // test for potentially valid hash
-                if (round2State2[7] == 0U)
+                // test for potentially valid hash, the last word of the final state is 0xa41f32e7 before the initial
+                // state is added back
+                if (TransformFinal(round2W) == 0xa41f32e7U)
                     // actual nonce is flipped
                     return Memory.ReverseEndian(nonce);
 
-                // only report and check for exit conditions every so often
-                if ((++nonce % 65536) == 0)
-                    if (!Progress(work, 65536) || nonce == 0)
+                // abandon stale work promptly, reading the generation counter is cheap next to 256 double hashes even
+                // at the rate of an unoptimized build; only report and check for other exit conditions every so often
+                nonce++;
+                if ((++done % 256) == 0)
+                {
+                    if (work.IsStale)
                         break;
+
+                    if ((done % 65536) == 0)
+                        if (!Progress(work, 65536) || done >= work.NonceCount)
+                            break;
+                }
             }
 
             return null;
         }
 
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        static uint Rotr(uint x, int n)
+        {
+            return (x >> n) | (x << (32 - n));
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        static uint Ch(uint x, uint y, uint z)
+        {
+            return z ^ (x & (y ^ z));
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        static uint Maj(uint x, uint y, uint z)
+        {
+            return (x & y) | (z & (x | y));
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        static uint Sigma0(uint x)
+        {
+            return Rotr(x, 2) ^ Rotr(x, 13) ^ Rotr(x, 22);
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        static uint Sigma1(uint x)
+        {
+            return Rotr(x, 6) ^ Rotr(x, 11) ^ Rotr(x, 25);
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        static uint sigma0(uint x)
+        {
+            return Rotr(x, 7) ^ Rotr(x, 18) ^ (x >> 3);
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        static uint sigma1(uint x)
+        {
+            return Rotr(x, 17) ^ Rotr(x, 19) ^ (x >> 10);
+        }
+
+        /// <summary>
+        /// Calculates the portion of the round 1 block 2 transform which does not depend on the nonce: the state after the
+        /// first three rounds with the nonce independent half of the fourth applied into <paramref name="mid"/>, and partial
+        /// message schedule entries into <paramref name="W"/>.
+        /// </summary>
+        /// <param name="state"></param>
+        /// <param name="block"></param>
+        /// <param name="mid"></param>
+        /// <param name="W"></param>
+        static unsafe void Precalc(uint* state, uint* block, uint* mid, uint* W)
+        {
+            uint t1, t2;
+
+            // read existing state
+            uint a = state[0];
+            uint b = state[1];
+            uint c = state[2];
+            uint d = state[3];
+            uint e = state[4];
+            uint f = state[5];
+            uint g = state[6];
+            uint h = state[7];
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0x428a2f98U + block[0];
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0x71374491U + block[1];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0xb5c0fbcfU + block[2];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+
+            // fourth round, less the nonce
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0xe9b5dba5U;
+            t2 = Sigma0(f) + Maj(f, g, h);
+
+            mid[0] = a + t1;
+            mid[1] = b;
+            mid[2] = c;
+            mid[3] = d;
+            mid[4] = t1 + t2;
+            mid[5] = f;
+            mid[6] = g;
+            mid[7] = h;
+
+            // W[16], W[17] and the nonce independent terms of W[18], W[19], W[31] and W[32]
+            W[0] = sigma0(block[1]) + block[0];
+            W[1] = 0x01100000U + sigma0(block[2]) + block[1];
+            W[2] = sigma1(W[0]) + block[2];
+            W[3] = sigma1(W[1]) + 0x11002000U;
+            W[4] = sigma0(W[0]) + 0x00000280U;
+            W[5] = sigma0(W[1]) + W[0];
+        }
+
+        /// <summary>
+        /// Transforms round 1 block 2 for the given nonce, starting from the values calculated by <see cref="M:Precalc"/>,
+        /// into the first 8 words of the round 2 block <paramref name="dst"/>. The remainder of the block is the fixed
+        /// SHA-256 padding of an 80 byte header. <paramref name="W"/> is scratch space for the message schedule.
+        /// </summary>
+        /// <param name="state"></param>
+        /// <param name="mid"></param>
+        /// <param name="pre"></param>
+        /// <param name="nonce"></param>
+        /// <param name="W"></param>
+        /// <param name="dst"></param>
+        static unsafe void TransformNonce(uint* state, uint* mid, uint* pre, uint nonce, uint* W, uint* dst)
+        {
+            uint t1, t2;
+
+            W[16] = pre[0];
+            W[17] = pre[1];
+            W[18] = pre[2] + sigma0(nonce);
+            W[19] = pre[3] + nonce;
+            W[20] = sigma1(W[18]) + 0x80000000U;
+            W[21] = sigma1(W[19]);
+            W[22] = sigma1(W[20]) + 0x00000280U;
+            W[23] = sigma1(W[23 - 2]) + W[23 - 7];
+            W[24] = sigma1(W[24 - 2]) + W[24 - 7];
+            W[25] = sigma1(W[25 - 2]) + W[25 - 7];
+            W[26] = sigma1(W[26 - 2]) + W[26 - 7];
+            W[27] = sigma1(W[27 - 2]) + W[27 - 7];
+            W[28] = sigma1(W[28 - 2]) + W[28 - 7];
+            W[29] = sigma1(W[29 - 2]) + W[29 - 7];
+            W[30] = sigma1(W[30 - 2]) + W[30 - 7] + 0x00a00055U;
+            W[31] = sigma1(W[31 - 2]) + W[31 - 7] + pre[4];
+            W[32] = sigma1(W[32 - 2]) + W[32 - 7] + pre[5];
+            W[33] = sigma1(W[33 - 2]) + W[33 - 7] + sigma0(W[33 - 15]) + W[33 - 16];
+            W[34] = sigma1(W[34 - 2]) + W[34 - 7] + sigma0(W[34 - 15]) + W[34 - 16];
+            W[35] = sigma1(W[35 - 2]) + W[35 - 7] + sigma0(W[35 - 15]) + W[35 - 16];
+            W[36] = sigma1(W[36 - 2]) + W[36 - 7] + sigma0(W[36 - 15]) + W[36 - 16];
+            W[37] = sigma1(W[37 - 2]) + W[37 - 7] + sigma0(W[37 - 15]) + W[37 - 16];
+            W[38] = sigma1(W[38 - 2]) + W[38 - 7] + sigma0(W[38 - 15]) + W[38 - 16];
+            W[39] = sigma1(W[39 - 2]) + W[39 - 7] + sigma0(W[39 - 15]) + W[39 - 16];
+            W[40] = sigma1(W[40 - 2]) + W[40 - 7] + sigma0(W[40 - 15]) + W[40 - 16];
+            W[41] = sigma1(W[41 - 2]) + W[41 - 7] + sigma0(W[41 - 15]) + W[41 - 16];
+            W[42] = sigma1(W[42 - 2]) + W[42 - 7] + sigma0(W[42 - 15]) + W[42 - 16];
+            W[43] = sigma1(W[43 - 2]) + W[43 - 7] + sigma0(W[43 - 15]) + W[43 - 16];
+            W[44] = sigma1(W[44 - 2]) + W[44 - 7] + sigma0(W[44 - 15]) + W[44 - 16];
+            W[45] = sigma1(W[45 - 2]) + W[45 - 7] + sigma0(W[45 - 15]) + W[45 - 16];
+            W[46] = sigma1(W[46 - 2]) + W[46 - 7] + sigma0(W[46 - 15]) + W[46 - 16];
+            W[47] = sigma1(W[47 - 2]) + W[47 - 7] + sigma0(W[47 - 15]) + W[47 - 16];
+            W[48] = sigma1(W[48 - 2]) + W[48 - 7] + sigma0(W[48 - 15]) + W[48 - 16];
+            W[49] = sigma1(W[49 - 2]) + W[49 - 7] + sigma0(W[49 - 15]) + W[49 - 16];
+            W[50] = sigma1(W[50 - 2]) + W[50 - 7] + sigma0(W[50 - 15]) + W[50 - 16];
+            W[51] = sigma1(W[51 - 2]) + W[51 - 7] + sigma0(W[51 - 15]) + W[51 - 16];
+            W[52] = sigma1(W[52 - 2]) + W[52 - 7] + sigma0(W[52 - 15]) + W[52 - 16];
+            W[53] = sigma1(W[53 - 2]) + W[53 - 7] + sigma0(W[53 - 15]) + W[53 - 16];
+            W[54] = sigma1(W[54 - 2]) + W[54 - 7] + sigma0(W[54 - 15]) + W[54 - 16];
+            W[55] = sigma1(W[55 - 2]) + W[55 - 7] + sigma0(W[55 - 15]) + W[55 - 16];
+            W[56] = sigma1(W[56 - 2]) + W[56 - 7] + sigma0(W[56 - 15]) + W[56 - 16];
+            W[57] = sigma1(W[57 - 2]) + W[57 - 7] + sigma0(W[57 - 15]) + W[57 - 16];
+            W[58] = sigma1(W[58 - 2]) + W[58 - 7] + sigma0(W[58 - 15]) + W[58 - 16];
+            W[59] = sigma1(W[59 - 2]) + W[59 - 7] + sigma0(W[59 - 15]) + W[59 - 16];
+            W[60] = sigma1(W[60 - 2]) + W[60 - 7] + sigma0(W[60 - 15]) + W[60 - 16];
+            W[61] = sigma1(W[61 - 2]) + W[61 - 7] + sigma0(W[61 - 15]) + W[61 - 16];
+            W[62] = sigma1(W[62 - 2]) + W[62 - 7] + sigma0(W[62 - 15]) + W[62 - 16];
+            W[63] = sigma1(W[63 - 2]) + W[63 - 7] + sigma0(W[63 - 15]) + W[63 - 16];
+
+            // complete the fourth round with the nonce
+            uint a = mid[0] + nonce;
+            uint b = mid[1];
+            uint c = mid[2];
+            uint d = mid[3];
+            uint e = mid[4] + nonce;
+            uint f = mid[5];
+            uint g = mid[6];
+            uint h = mid[7];
+
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0xb956c25bU;
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0x59f111f1U;
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0x923f82a4U;
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0xab1c5ed5U;
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0xd807aa98U;
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0x12835b01U;
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0x243185beU;
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0x550c7dc3U;
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0x72be5d74U;
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0x80deb1feU;
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0x9bdc06a7U;
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0xc19bf3f4U;
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0xe49b69c1U + W[16];
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0xefbe4786U + W[17];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0x0fc19dc6U + W[18];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0x240ca1ccU + W[19];
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0x2de92c6fU + W[20];
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0x4a7484aaU + W[21];
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0x5cb0a9dcU + W[22];
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0x76f988daU + W[23];
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0x983e5152U + W[24];
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0xa831c66dU + W[25];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0xb00327c8U + W[26];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0xbf597fc7U + W[27];
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0xc6e00bf3U + W[28];
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0xd5a79147U + W[29];
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0x06ca6351U + W[30];
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0x14292967U + W[31];
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0x27b70a85U + W[32];
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0x2e1b2138U + W[33];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0x4d2c6dfcU + W[34];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0x53380d13U + W[35];
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0x650a7354U + W[36];
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0x766a0abbU + W[37];
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0x81c2c92eU + W[38];
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0x92722c85U + W[39];
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0xa2bfe8a1U + W[40];
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0xa81a664bU + W[41];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0xc24b8b70U + W[42];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0xc76c51a3U + W[43];
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0xd192e819U + W[44];
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0xd6990624U + W[45];
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0xf40e3585U + W[46];
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0x106aa070U + W[47];
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0x19a4c116U + W[48];
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0x1e376c08U + W[49];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0x2748774cU + W[50];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0x34b0bcb5U + W[51];
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0x391c0cb3U + W[52];
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0x4ed8aa4aU + W[53];
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0x5b9cca4fU + W[54];
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0x682e6ff3U + W[55];
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0x748f82eeU + W[56];
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0x78a5636fU + W[57];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0x84c87814U + W[58];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0x8cc70208U + W[59];
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0x90befffaU + W[60];
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0xa4506cebU + W[61];
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0xbef9a3f7U + W[62];
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0xc67178f2U + W[63];
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            dst[0] = state[0] + a;
+            dst[1] = state[1] + b;
+            dst[2] = state[2] + c;
+            dst[3] = state[3] + d;
+            dst[4] = state[4] + e;
+            dst[5] = state[5] + f;
+            dst[6] = state[6] + g;
+            dst[7] = state[7] + h;
+        }
+
+        /// <summary>
+        /// Transforms the round 2 block held in the first 8 words of <paramref name="W"/> from the initial SHA-256 state,
+        /// returning only the last word of the state less its initial value. The remainder of the block is the fixed SHA-256
+        /// padding of a 32 byte hash, and <paramref name="W"/> is expanded in place into the message schedule.
+        /// </summary>
+        /// <param name="W"></param>
+        /// <returns></returns>
+        static unsafe uint TransformFinal(uint* W)
+        {
+            uint t1, t2;
+
+            W[16] = sigma0(W[1]) + W[0];
+            W[17] = 0x00a00000U + sigma0(W[2]) + W[1];
+            W[18] = sigma1(W[18 - 2]) + sigma0(W[18 - 15]) + W[18 - 16];
+            W[19] = sigma1(W[19 - 2]) + sigma0(W[19 - 15]) + W[19 - 16];
+            W[20] = sigma1(W[20 - 2]) + sigma0(W[20 - 15]) + W[20 - 16];
+            W[21] = sigma1(W[21 - 2]) + sigma0(W[21 - 15]) + W[21 - 16];
+            W[22] = sigma1(W[22 - 2]) + 0x00000100U + sigma0(W[22 - 15]) + W[22 - 16];
+            W[23] = sigma1(W[23 - 2]) + W[23 - 7] + 0x11002000U + W[23 - 16];
+            W[24] = sigma1(W[24 - 2]) + W[24 - 7] + 0x80000000U;
+            W[25] = sigma1(W[25 - 2]) + W[25 - 7];
+            W[26] = sigma1(W[26 - 2]) + W[26 - 7];
+            W[27] = sigma1(W[27 - 2]) + W[27 - 7];
+            W[28] = sigma1(W[28 - 2]) + W[28 - 7];
+            W[29] = sigma1(W[29 - 2]) + W[29 - 7];
+            W[30] = sigma1(W[30 - 2]) + W[30 - 7] + 0x00400022U;
+            W[31] = sigma1(W[31 - 2]) + W[31 - 7] + sigma0(W[31 - 15]) + 0x00000100U;
+            W[32] = sigma1(W[32 - 2]) + W[32 - 7] + sigma0(W[32 - 15]) + W[32 - 16];
+            W[33] = sigma1(W[33 - 2]) + W[33 - 7] + sigma0(W[33 - 15]) + W[33 - 16];
+            W[34] = sigma1(W[34 - 2]) + W[34 - 7] + sigma0(W[34 - 15]) + W[34 - 16];
+            W[35] = sigma1(W[35 - 2]) + W[35 - 7] + sigma0(W[35 - 15]) + W[35 - 16];
+            W[36] = sigma1(W[36 - 2]) + W[36 - 7] + sigma0(W[36 - 15]) + W[36 - 16];
+            W[37] = sigma1(W[37 - 2]) + W[37 - 7] + sigma0(W[37 - 15]) + W[37 - 16];
+            W[38] = sigma1(W[38 - 2]) + W[38 - 7] + sigma0(W[38 - 15]) + W[38 - 16];
+            W[39] = sigma1(W[39 - 2]) + W[39 - 7] + sigma0(W[39 - 15]) + W[39 - 16];
+            W[40] = sigma1(W[40 - 2]) + W[40 - 7] + sigma0(W[40 - 15]) + W[40 - 16];
+            W[41] = sigma1(W[41 - 2]) + W[41 - 7] + sigma0(W[41 - 15]) + W[41 - 16];
+            W[42] = sigma1(W[42 - 2]) + W[42 - 7] + sigma0(W[42 - 15]) + W[42 - 16];
+            W[43] = sigma1(W[43 - 2]) + W[43 - 7] + sigma0(W[43 - 15]) + W[43 - 16];
+            W[44] = sigma1(W[44 - 2]) + W[44 - 7] + sigma0(W[44 - 15]) + W[44 - 16];
+            W[45] = sigma1(W[45 - 2]) + W[45 - 7] + sigma0(W[45 - 15]) + W[45 - 16];
+            W[46] = sigma1(W[46 - 2]) + W[46 - 7] + sigma0(W[46 - 15]) + W[46 - 16];
+            W[47] = sigma1(W[47 - 2]) + W[47 - 7] + sigma0(W[47 - 15]) + W[47 - 16];
+            W[48] = sigma1(W[48 - 2]) + W[48 - 7] + sigma0(W[48 - 15]) + W[48 - 16];
+            W[49] = sigma1(W[49 - 2]) + W[49 - 7] + sigma0(W[49 - 15]) + W[49 - 16];
+            W[50] = sigma1(W[50 - 2]) + W[50 - 7] + sigma0(W[50 - 15]) + W[50 - 16];
+            W[51] = sigma1(W[51 - 2]) + W[51 - 7] + sigma0(W[51 - 15]) + W[51 - 16];
+            W[52] = sigma1(W[52 - 2]) + W[52 - 7] + sigma0(W[52 - 15]) + W[52 - 16];
+            W[53] = sigma1(W[53 - 2]) + W[53 - 7] + sigma0(W[53 - 15]) + W[53 - 16];
+            W[54] = sigma1(W[54 - 2]) + W[54 - 7] + sigma0(W[54 - 15]) + W[54 - 16];
+            W[55] = sigma1(W[55 - 2]) + W[55 - 7] + sigma0(W[55 - 15]) + W[55 - 16];
+            W[56] = sigma1(W[56 - 2]) + W[56 - 7] + sigma0(W[56 - 15]) + W[56 - 16];
+            W[57] = sigma1(W[57 - 2]) + W[57 - 7] + sigma0(W[57 - 15]) + W[57 - 16];
+            W[58] = sigma1(W[58 - 2]) + W[58 - 7] + sigma0(W[58 - 15]) + W[58 - 16];
+            W[59] = sigma1(W[59 - 2]) + W[59 - 7] + sigma0(W[59 - 15]) + W[59 - 16];
+            W[60] = sigma1(W[60 - 2]) + W[60 - 7] + sigma0(W[60 - 15]) + W[60 - 16];
+
+            // initial state, with the first round applied
+            uint a = 0x6a09e667U;
+            uint b = 0xbb67ae85U;
+            uint c = 0x3c6ef372U;
+            uint d = 0x98c7e2a2U + W[0];
+            uint e = 0x510e527fU;
+            uint f = 0x9b05688cU;
+            uint g = 0x1f83d9abU;
+            uint h = 0xfc08884dU + W[0];
+
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0x71374491U + W[1];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0xb5c0fbcfU + W[2];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0xe9b5dba5U + W[3];
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0x3956c25bU + W[4];
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0x59f111f1U + W[5];
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0x923f82a4U + W[6];
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0xab1c5ed5U + W[7];
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0x5807aa98U;
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0x12835b01U;
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0x243185beU;
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0x550c7dc3U;
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0x72be5d74U;
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0x80deb1feU;
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0x9bdc06a7U;
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0xc19bf274U;
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0xe49b69c1U + W[16];
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0xefbe4786U + W[17];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0x0fc19dc6U + W[18];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0x240ca1ccU + W[19];
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0x2de92c6fU + W[20];
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0x4a7484aaU + W[21];
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0x5cb0a9dcU + W[22];
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0x76f988daU + W[23];
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0x983e5152U + W[24];
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0xa831c66dU + W[25];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0xb00327c8U + W[26];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0xbf597fc7U + W[27];
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0xc6e00bf3U + W[28];
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0xd5a79147U + W[29];
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0x06ca6351U + W[30];
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0x14292967U + W[31];
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0x27b70a85U + W[32];
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0x2e1b2138U + W[33];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0x4d2c6dfcU + W[34];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0x53380d13U + W[35];
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0x650a7354U + W[36];
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0x766a0abbU + W[37];
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0x81c2c92eU + W[38];
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0x92722c85U + W[39];
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0xa2bfe8a1U + W[40];
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0xa81a664bU + W[41];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0xc24b8b70U + W[42];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0xc76c51a3U + W[43];
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0xd192e819U + W[44];
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0xd6990624U + W[45];
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0xf40e3585U + W[46];
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0x106aa070U + W[47];
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0x19a4c116U + W[48];
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0x1e376c08U + W[49];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0x2748774cU + W[50];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0x34b0bcb5U + W[51];
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0x391c0cb3U + W[52];
+            t2 = Sigma0(e) + Maj(e, f, g); h = h + t1; d = t1 + t2;
+            t1 = c + Sigma1(h) + Ch(h, a, b) + 0x4ed8aa4aU + W[53];
+            t2 = Sigma0(d) + Maj(d, e, f); g = g + t1; c = t1 + t2;
+            t1 = b + Sigma1(g) + Ch(g, h, a) + 0x5b9cca4fU + W[54];
+            t2 = Sigma0(c) + Maj(c, d, e); f = f + t1; b = t1 + t2;
+            t1 = a + Sigma1(f) + Ch(f, g, h) + 0x682e6ff3U + W[55];
+            t2 = Sigma0(b) + Maj(b, c, d); e = e + t1; a = t1 + t2;
+
+            t1 = h + Sigma1(e) + Ch(e, f, g) + 0x748f82eeU + W[56];
+            t2 = Sigma0(a) + Maj(a, b, c); d = d + t1; h = t1 + t2;
+            t1 = g + Sigma1(d) + Ch(d, e, f) + 0x78a5636fU + W[57];
+            t2 = Sigma0(h) + Maj(h, a, b); c = c + t1; g = t1 + t2;
+            t1 = f + Sigma1(c) + Ch(c, d, e) + 0x84c87814U + W[58];
+            t2 = Sigma0(g) + Maj(g, h, a); b = b + t1; f = t1 + t2;
+            t1 = e + Sigma1(b) + Ch(b, c, d) + 0x8cc70208U + W[59];
+            t2 = Sigma0(f) + Maj(f, g, h); a = a + t1; e = t1 + t2;
+
+            // only the last word of the state is tested, which is final after this round
+            t1 = d + Sigma1(a) + Ch(a, b, c) + 0x90befffaU + W[60];
+
+            return h + t1;
+        }
+
     }
 
 }
@@ -10,7 +10,7 @@ namespace BitMaker.Miner.Managed
     /// <summary>
     /// Factory for <see cref="T:ManagedMiner"/>.
     /// </summary>
-    [MinerFactory]
+    [MinerFactory(Device = MinerDeviceKind.Cpu)]
     public class ManagedMinerFactory : CpuMinerFactory
     {
 
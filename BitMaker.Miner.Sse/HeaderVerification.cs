@@ -0,0 +1,56 @@
+﻿using System;
+using System.Collections.Generic;
+
+namespace BitMaker.Miner.Sse
+{
+
+    /// <summary>
+    /// Outcome of verifying the proof of work of the block headers in a file.
+    /// </summary>
+    public class HeaderVerification
+    {
+
+        /// <summary>
+        /// Gets the file that was verified.
+        /// </summary>
+        public string Path { get; internal set; }
+
+        /// <summary>
+        /// Gets the number of headers found in the file.
+        /// </summary>
+        public long Headers { get; internal set; }
+
+        /// <summary>
+        /// Gets the size of the file.
+        /// </summary>
+        public long Bytes { get; internal set; }
+
+        /// <summary>
+        /// Gets the offsets within the file of the headers whose hash does not meet their target, in ascending order.
+        /// </summary>
+        public IList<long> Invalid { get; internal set; }
+
+        /// <summary>
+        /// Gets the time taken to verify the file.
+        /// </summary>
+        public TimeSpan Elapsed { get; internal set; }
+
+        /// <summary>
+        /// Gets the number of headers verified per second.
+        /// </summary>
+        public double HeadersPerSecond
+        {
+            get { return Elapsed > TimeSpan.Zero ? Headers / Elapsed.TotalSeconds : 0; }
+        }
+
+        /// <summary>
+        /// Gets the number of bytes of the file scanned per second.
+        /// </summary>
+        public double BytesPerSecond
+        {
+            get { return Elapsed > TimeSpan.Zero ? Bytes / Elapsed.TotalSeconds : 0; }
+        }
+
+    }
+
+}
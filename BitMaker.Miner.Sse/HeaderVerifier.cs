@@ -0,0 +1,158 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Threading.Tasks;
+
+using BitMaker.Utils;
+using BitMaker.Utils.Native;
+
+namespace BitMaker.Miner.Sse
+{
+
+    /// <summary>
+    /// Verifies the proof of work of block headers in bulk. Files are memory mapped and either hold raw 80 byte headers
+    /// one after another, or are the blk*.dat block files of the reference client. Headers are hashed in batches by
+    /// the SSE engine, several at once per processor, across all processors.
+    /// </summary>
+    public static class HeaderVerifier
+    {
+
+        /// <summary>
+        /// Size of a block header.
+        /// </summary>
+        public const int HEADER_SIZE = 80;
+
+        /// <summary>
+        /// Marker which starts each record of a block file.
+        /// </summary>
+        public const uint BLOCK_FILE_MAGIC = 0xd9b4bef9U;
+
+        /// <summary>
+        /// Number of headers hashed by a single native call.
+        /// </summary>
+        const int BATCH_SIZE = 1024;
+
+        /// <summary>
+        /// Verifies each header in the file at <paramref name="path"/> against the target encoded in it.
+        /// </summary>
+        /// <param name="path"></param>
+        /// <returns></returns>
+        public static unsafe HeaderVerification Verify(string path)
+        {
+            if (!SseMinerUtils.Detect())
+                throw new NotSupportedException("Verifying headers requires SSE2.");
+
+            var stopwatch = Stopwatch.StartNew();
+            var result = new HeaderVerification()
+            {
+                Path = path,
+                Bytes = new FileInfo(path).Length,
+                Invalid = new long[0],
+            };
+
+            // an empty file cannot be mapped
+            if (result.Bytes == 0)
+                return result;
+
+            using (var file = MemoryMappedFile.CreateFromFile(path, FileMode.Open, null, 0, MemoryMappedFileAccess.Read))
+            using (var view = file.CreateViewAccessor(0, 0, MemoryMappedFileAccess.Read))
+            {
+                byte* data = null;
+                view.SafeMemoryMappedViewHandle.AcquirePointer(ref data);
+
+                try
+                {
+                    var offsets = FindHeaders(data, result.Bytes);
+                    result.Headers = offsets.Length;
+                    result.Invalid = Check(data, offsets);
+                }
+                finally
+                {
+                    view.SafeMemoryMappedViewHandle.ReleasePointer();
+                }
+            }
+
+            result.Elapsed = stopwatch.Elapsed;
+            return result;
+        }
+
+        /// <summary>
+        /// Returns the offset of each header within the <paramref name="length"/> bytes at <paramref name="data"/>.
+        /// </summary>
+        /// <param name="data"></param>
+        /// <param name="length"></param>
+        /// <returns></returns>
+        static unsafe long[] FindHeaders(byte* data, long length)
+        {
+            // block files are a sequence of records of the magic, the size of the block and the block, which starts with
+            // its header; they are preallocated, so the records end where the magic is no longer found
+            if (length >= 8 && *(uint*)data == BLOCK_FILE_MAGIC)
+            {
+                var offsets = new List<long>();
+
+                for (long position = 0; position + 8 <= length && *(uint*)(data + position) == BLOCK_FILE_MAGIC; )
+                {
+                    var size = *(uint*)(data + position + 4);
+                    if (size < HEADER_SIZE || position + 8 + size > length)
+                        throw new InvalidDataException(string.Format("Truncated block record at offset {0}.", position));
+
+                    offsets.Add(position + 8);
+                    position += 8 + size;
+                }
+
+                return offsets.ToArray();
+            }
+
+            if (length % HEADER_SIZE != 0)
+                throw new InvalidDataException("File is neither a block file nor a sequence of block headers.");
+
+            var headers = new long[length / HEADER_SIZE];
+            for (long i = 0; i < headers.Length; i++)
+                headers[i] = i * HEADER_SIZE;
+
+            return headers;
+        }
+
+        /// <summary>
+        /// Hashes the headers at <paramref name="offsets"/> within <paramref name="data"/>, and returns the offsets of
+        /// those which do not meet their target.
+        /// </summary>
+        /// <param name="data"></param>
+        /// <param name="offsets"></param>
+        /// <returns></returns>
+        static unsafe IList<long> Check(byte* data, long[] offsets)
+        {
+            var invalid = new List<long>();
+            var dataPtr = (IntPtr)data;
+
+            Parallel.For(0, (offsets.Length + BATCH_SIZE - 1) / BATCH_SIZE, batch =>
+            {
+                var first = batch * BATCH_SIZE;
+                var count = Math.Min(BATCH_SIZE, offsets.Length - first);
+                var headers = stackalloc byte*[count];
+                var hashes = stackalloc byte[count * Sha256.SHA256_HASH_SIZE];
+                var target = stackalloc byte[Sha256.SHA256_HASH_SIZE];
+
+                for (int i = 0; i < count; i++)
+                    headers[i] = (byte*)dataPtr + offsets[first + i];
+
+                SseMinerUtils.HashHeaders(headers, (uint)count, hashes);
+
+                for (int i = 0; i < count; i++)
+                {
+                    var header = (BlockHeaderWindow*)headers[i];
+                    if (!header->GetTarget(target) || !BlockHeaderWindow.MeetsTarget(hashes + i * Sha256.SHA256_HASH_SIZE, target))
+                        lock (invalid)
+                            invalid.Add(offsets[first + i]);
+                }
+            });
+
+            invalid.Sort();
+            return invalid;
+        }
+
+    }
+
+}
@@ -1,4 +1,5 @@
-﻿using System.Threading;
+﻿using System;
+using System.Threading;
 
 using BitMaker.Miner.Cpu;
 using BitMaker.Utils.Native;
@@ -9,6 +10,30 @@ namespace BitMaker.Miner.Sse
     public class SseMiner : CpuMiner
     {
 
+        /// <summary>
+        /// Configured number of work items to search together, rounded down to a divisor of the lane count.
+        /// </summary>
+        static readonly int packedWorkCount = GetPackedWorkCount(ConfigurationSection.GetDefaultSection().PackedWork);
+
+        /// <summary>
+        /// Gets the largest supported number of packed work items not exceeding <paramref name="count"/>.
+        /// </summary>
+        /// <param name="count"></param>
+        /// <returns></returns>
+        static int GetPackedWorkCount(int count)
+        {
+            count = Math.Min(Math.Max(count, 1), SseMinerUtils.Lanes);
+            while (SseMinerUtils.Lanes % count != 0)
+                count--;
+
+            return count;
+        }
+
+        /// <summary>
+        /// Invoked periodically by native code, created once so that searches do not allocate it.
+        /// </summary>
+        readonly SseCheckDelegate check;
+
         /// <summary>
         /// Initializes a new instance.
         /// </summary>
@@ -17,7 +42,21 @@ namespace BitMaker.Miner.Sse
         public SseMiner(IMinerContext context, CpuDevice cpu)
             : base(context, cpu)
         {
+            check = Check;
+        }
 
+        /// <summary>
+        /// Reports hashes and determines whether the search should continue.
+        /// </summary>
+        /// <param name="hashCount"></param>
+        /// <returns></returns>
+        bool Check(uint hashCount)
+        {
+            // report hashes to context
+            Context.ReportHashes(this, hashCount);
+
+            // abort if instructed to, or if our processor is parked; native code watches for stale work itself
+            return !CancellationToken.IsCancellationRequested && !Cpu.Parked;
         }
 
         /// <summary>
@@ -26,23 +65,52 @@ namespace BitMaker.Miner.Sse
         /// <param name="work"></param>
         /// <param name="round1State"></param>
         /// <param name="round1Block2"></param>
-        /// <param name="round2State"></param>
-        /// <param name="round2Block1"></param>
         /// <returns></returns>
-        public override unsafe uint? Search(Work work, uint* round1State, byte* round1Block2, uint* round2State, byte* round2Block1)
+        public override unsafe uint? Search(Work work, uint* round1State, byte* round1Block2)
+        {
+            // dispatch work to native implementation
+            return SseMinerUtils.Search(round1State, round1Block2, work.NonceStart, (ulong)work.NonceCount, (uint*)work.GenerationPtr, (uint)work.Generation, check);
+        }
+
+        /// <summary>
+        /// Number of work items searched together.
+        /// </summary>
+        public override int PackedWorkCount
+        {
+            get { return packedWorkCount; }
+        }
+
+        /// <summary>
+        /// Implements the packed search function by passing it to native code.
+        /// </summary>
+        /// <param name="works"></param>
+        /// <param name="round1States"></param>
+        /// <param name="round1Blocks2"></param>
+        /// <param name="index"></param>
+        /// <returns></returns>
+        public override unsafe uint? Search(Work[] works, uint* round1States, byte* round1Blocks2, out int index)
         {
-            // invoked periodically to report hashes and check status
-            var check = (SseCheckDelegate)(i =>
+            // each work is searched from its own start over the same number of nonces, until the generation counter of
+            // its pool moves on from the generation the work belongs to
+            var starts = stackalloc uint[works.Length];
+            var count = works[0].NonceCount;
+            var generations = stackalloc uint*[works.Length];
+            var expected = stackalloc uint[works.Length];
+            for (int i = 0; i < works.Length; i++)
             {
-                // report hashes to context
-                Context.ReportHashes(this, i);
+                if (works[i].NonceCount != count)
+                    throw new ArgumentException("Work items searched together must have the same nonce count.", "works");
 
-                // abort if we are working on stale work, or if instructed to
-                return work.Pool.CurrentBlockNumber == work.BlockNumber && !CancellationToken.IsCancellationRequested;
-            });
+                starts[i] = works[i].NonceStart;
+                generations[i] = (uint*)works[i].GenerationPtr;
+                expected[i] = (uint)works[i].Generation;
+            }
 
             // dispatch work to native implementation
-            return SseMinerUtils.Search(round1State, round1Block2, round2State, round2Block1, check);
+            uint workIndex;
+            var nonce = SseMinerUtils.SearchPacked(round1States, round1Blocks2, (uint)works.Length, starts, (ulong)count, generations, expected, out workIndex, check);
+            index = (int)workIndex;
+            return nonce;
         }
 
     }
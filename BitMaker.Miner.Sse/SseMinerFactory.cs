@@ -11,7 +11,7 @@ namespace BitMaker.Miner.Sse
     /// <summary>
     /// Factory for <see cref="SseMiner"/>.
     /// </summary>
-    [MinerFactory]
+    [MinerFactory(Device = MinerDeviceKind.Cpu, Requires = InstructionSet.Sse2, Priority = 1)]
     public class SseMinerFactory : CpuMinerFactory
     {
 
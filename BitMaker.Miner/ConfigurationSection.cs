@@ -30,6 +30,86 @@ namespace BitMaker.Miner
             get { return (PoolsConfigurationCollection)this["pools"]; }
         }
 
+        /// <summary>
+        /// Gets or sets the number of work items the vector CPU miners search together, one per group of lanes. Miners
+        /// round it down to what their vector width supports.
+        /// </summary>
+        [ConfigurationProperty("packedWork", DefaultValue = 1)]
+        [IntegerValidator(MinValue = 1)]
+        public int PackedWork
+        {
+            get { return (int)this["packedWork"]; }
+            set { this["packedWork"] = value; }
+        }
+
+        /// <summary>
+        /// Gets or sets the number of hardware threads of each CPU core to run miners on. A value of zero uses all of
+        /// them.
+        /// </summary>
+        [ConfigurationProperty("threadsPerCore", DefaultValue = 0)]
+        [IntegerValidator(MinValue = 0)]
+        public int ThreadsPerCore
+        {
+            get { return (int)this["threadsPerCore"]; }
+            set { this["threadsPerCore"] = value; }
+        }
+
+        /// <summary>
+        /// Gets or sets how often the miner running on each device is compared against its alternatives. A value of
+        /// zero disables re-selection.
+        /// </summary>
+        [ConfigurationProperty("reselectInterval", DefaultValue = "00:05:00")]
+        public TimeSpan ReselectInterval
+        {
+            get { return (TimeSpan)this["reselectInterval"]; }
+            set { this["reselectInterval"] = value; }
+        }
+
+        /// <summary>
+        /// Gets or sets the fraction by which an alternative miner must outperform the running miner before a device
+        /// is switched over.
+        /// </summary>
+        [ConfigurationProperty("reselectThreshold", DefaultValue = 0.1)]
+        public double ReselectThreshold
+        {
+            get { return (double)this["reselectThreshold"]; }
+            set { this["reselectThreshold"] = value; }
+        }
+
+        /// <summary>
+        /// Gets or sets whether the host runs for the most hashes per second, or the most hashes per joule as measured
+        /// by the RAPL energy counters.
+        /// </summary>
+        [ConfigurationProperty("efficiencyPolicy", DefaultValue = EfficiencyPolicy.Throughput)]
+        public EfficiencyPolicy EfficiencyPolicy
+        {
+            get { return (EfficiencyPolicy)this["efficiencyPolicy"]; }
+            set { this["efficiencyPolicy"] = value; }
+        }
+
+        /// <summary>
+        /// Gets or sets how often the hash rate and power of the running miners are reported and, under the efficiency
+        /// policy, the kernel and number of devices are chosen again. Independent of re-selection. A value of zero
+        /// disables the periodic measurement.
+        /// </summary>
+        [ConfigurationProperty("efficiencyInterval", DefaultValue = "00:05:00")]
+        public TimeSpan EfficiencyInterval
+        {
+            get { return (TimeSpan)this["efficiencyInterval"]; }
+            set { this["efficiencyInterval"] = value; }
+        }
+
+        /// <summary>
+        /// Gets or sets whether the native work buffers of each miner thread are backed by large pages, where the system
+        /// grants them.
+        /// </summary>
+        [ConfigurationProperty("largePages", DefaultValue = false)]
+        public bool LargePages
+        {
+            get { return (bool)this["largePages"]; }
+            set { this["largePages"] = value; }
+        }
+
     }
 
 }
@@ -0,0 +1,126 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+
+namespace BitMaker.Miner
+{
+
+    /// <summary>
+    /// Correlates the hash count of the host with the energy consumed, to measure the hash rate and power of each
+    /// configuration of running miners and select the best one under the configured policy.
+    /// </summary>
+    public class EfficiencyController
+    {
+
+        readonly IEnergySource energy;
+        readonly Func<long> hashCount;
+        readonly Stopwatch stopwatch = Stopwatch.StartNew();
+
+        long lastHashCount;
+        double lastJoules;
+        double lastTime;
+
+        /// <summary>
+        /// Initializes a new instance.
+        /// </summary>
+        /// <param name="energy"></param>
+        /// <param name="hashCount">returns the total number of hashes generated</param>
+        /// <param name="policy"></param>
+        public EfficiencyController(IEnergySource energy, Func<long> hashCount, EfficiencyPolicy policy)
+        {
+            this.energy = energy;
+            this.hashCount = hashCount;
+            Policy = policy;
+
+            Reset();
+        }
+
+        /// <summary>
+        /// Gets the source of energy readings.
+        /// </summary>
+        public IEnergySource Energy
+        {
+            get { return energy; }
+        }
+
+        /// <summary>
+        /// Gets what configurations are selected for.
+        /// </summary>
+        public EfficiencyPolicy Policy { get; private set; }
+
+        /// <summary>
+        /// Begins a new sample.
+        /// </summary>
+        public void Reset()
+        {
+            lastHashCount = hashCount();
+            lastJoules = energy.Joules;
+            lastTime = stopwatch.Elapsed.TotalSeconds;
+        }
+
+        /// <summary>
+        /// Ends the current sample and begins a new one, returning the hash rate and power since the previous.
+        /// </summary>
+        /// <param name="name"></param>
+        /// <returns></returns>
+        public EfficiencySample Sample(string name)
+        {
+            var count = hashCount();
+            var joules = energy.Joules;
+            var time = stopwatch.Elapsed.TotalSeconds;
+            var duration = Math.Max(time - lastTime, 0.001);
+
+            var sample = new EfficiencySample()
+            {
+                Name = name,
+                HashesPerSecond = (count - lastHashCount) / duration,
+                Watts = (joules - lastJoules) / duration,
+            };
+
+            lastHashCount = count;
+            lastJoules = joules;
+            lastTime = time;
+            return sample;
+        }
+
+        /// <summary>
+        /// Measures the current configuration for the given duration.
+        /// </summary>
+        /// <param name="name"></param>
+        /// <param name="duration"></param>
+        /// <returns></returns>
+        public EfficiencySample Measure(string name, TimeSpan duration)
+        {
+            Reset();
+            Thread.Sleep(duration);
+            return Sample(name);
+        }
+
+        /// <summary>
+        /// Selects the best of the measured samples under the policy.
+        /// </summary>
+        /// <param name="curve"></param>
+        /// <returns></returns>
+        public EfficiencySample Select(IEnumerable<EfficiencySample> curve)
+        {
+            if (Policy == EfficiencyPolicy.Efficiency)
+                return curve.OrderByDescending(i => i.HashesPerJoule).FirstOrDefault();
+            else
+                return curve.OrderByDescending(i => i.HashesPerSecond).FirstOrDefault();
+        }
+
+        /// <summary>
+        /// Writes a measured sample to the console.
+        /// </summary>
+        /// <param name="sample"></param>
+        public static void Report(EfficiencySample sample)
+        {
+            Console.WriteLine("ENERGY  : {0,-20} {1,10:0.00} mhash/s {2,8:0.0} W {3,10:0.000} mhash/J",
+                sample.Name, sample.HashesPerSecond / 1000000, sample.Watts, sample.HashesPerJoule / 1000000);
+        }
+
+    }
+
+}
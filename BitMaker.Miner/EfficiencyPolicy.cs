@@ -0,0 +1,22 @@
+﻿namespace BitMaker.Miner
+{
+
+    /// <summary>
+    /// Determines what the host optimizes the set of running miners for.
+    /// </summary>
+    public enum EfficiencyPolicy
+    {
+
+        /// <summary>
+        /// Run the fastest miner on every device.
+        /// </summary>
+        Throughput,
+
+        /// <summary>
+        /// Run the kernel and number of devices which produce the most hashes per joule.
+        /// </summary>
+        Efficiency,
+
+    }
+
+}
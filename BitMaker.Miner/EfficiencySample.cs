@@ -0,0 +1,35 @@
+﻿namespace BitMaker.Miner
+{
+
+    /// <summary>
+    /// Hash rate and power measured for a configuration of running miners.
+    /// </summary>
+    public class EfficiencySample
+    {
+
+        /// <summary>
+        /// Description of the configuration.
+        /// </summary>
+        public string Name { get; set; }
+
+        /// <summary>
+        /// Measured hash rate.
+        /// </summary>
+        public double HashesPerSecond { get; set; }
+
+        /// <summary>
+        /// Measured power.
+        /// </summary>
+        public double Watts { get; set; }
+
+        /// <summary>
+        /// Hashes generated for each joule consumed.
+        /// </summary>
+        public double HashesPerJoule
+        {
+            get { return Watts > 0 ? HashesPerSecond / Watts : 0; }
+        }
+
+    }
+
+}
@@ -0,0 +1,23 @@
+﻿namespace BitMaker.Miner
+{
+
+    /// <summary>
+    /// Source of the energy consumed by the mining hardware.
+    /// </summary>
+    public interface IEnergySource
+    {
+
+        /// <summary>
+        /// Gets whether energy can be measured on this system.
+        /// </summary>
+        bool IsAvailable { get; }
+
+        /// <summary>
+        /// Gets the energy consumed in joules since an arbitrary point in time. Only differences between readings are
+        /// meaningful.
+        /// </summary>
+        double Joules { get; }
+
+    }
+
+}
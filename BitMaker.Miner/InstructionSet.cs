@@ -0,0 +1,27 @@
+﻿namespace BitMaker.Miner
+{
+
+    /// <summary>
+    /// Processor instruction set required by the miners of a factory.
+    /// </summary>
+    public enum InstructionSet
+    {
+
+        /// <summary>
+        /// Runs on any processor.
+        /// </summary>
+        None,
+
+        /// <summary>
+        /// Requires SSE2.
+        /// </summary>
+        Sse2,
+
+        /// <summary>
+        /// Requires AVX, and an operating system which saves its registers.
+        /// </summary>
+        Avx,
+
+    }
+
+}
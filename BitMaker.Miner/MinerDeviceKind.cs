@@ -0,0 +1,22 @@
+﻿namespace BitMaker.Miner
+{
+
+    /// <summary>
+    /// Kind of device the miners of a factory run on.
+    /// </summary>
+    public enum MinerDeviceKind
+    {
+
+        /// <summary>
+        /// Logical processors of the system.
+        /// </summary>
+        Cpu,
+
+        /// <summary>
+        /// OpenCL devices.
+        /// </summary>
+        Gpu,
+
+    }
+
+}
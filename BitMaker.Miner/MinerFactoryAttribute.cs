@@ -5,8 +5,10 @@ namespace BitMaker.Miner
 {
 
     /// <summary>
-    /// Marks a <see cref="IMinerFactory"/> as capable of generating miner instances.
+    /// Marks a <see cref="IMinerFactory"/> as capable of generating miner instances, and describes it so that the host
+    /// can choose factories without constructing them.
     /// </summary>
+    [MetadataAttribute]
     [AttributeUsage(AttributeTargets.Class)]
     public sealed class MinerFactoryAttribute : ExportAttribute, IMinerFactoryMetadata
     {
@@ -20,6 +22,21 @@ namespace BitMaker.Miner
 
         }
 
+        /// <summary>
+        /// Gets or sets the kind of device the miners of the factory run on.
+        /// </summary>
+        public MinerDeviceKind Device { get; set; }
+
+        /// <summary>
+        /// Gets or sets the instruction set the miners of the factory require.
+        /// </summary>
+        public InstructionSet Requires { get; set; }
+
+        /// <summary>
+        /// Gets or sets the preference for the factory over others for the same kind of device, highest first.
+        /// </summary>
+        public int Priority { get; set; }
+
     }
 
     /// <summary>
@@ -28,7 +45,20 @@ namespace BitMaker.Miner
     public interface IMinerFactoryMetadata
     {
 
+        /// <summary>
+        /// Gets the kind of device the miners of the factory run on.
+        /// </summary>
+        MinerDeviceKind Device { get; }
+
+        /// <summary>
+        /// Gets the instruction set the miners of the factory require.
+        /// </summary>
+        InstructionSet Requires { get; }
 
+        /// <summary>
+        /// Gets the preference for the factory over others for the same kind of device, highest first.
+        /// </summary>
+        int Priority { get; }
 
     }
 
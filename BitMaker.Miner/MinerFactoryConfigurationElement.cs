@@ -23,6 +23,18 @@ namespace BitMaker.Miner
             set { this["type"] = value; }
         }
 
+        /// <summary>
+        /// Gets or sets the number of hardware threads of each CPU core to run the miners of the factory on, for CPU
+        /// miner factories. A value of -1 uses the setting of the section.
+        /// </summary>
+        [ConfigurationProperty("threadsPerCore", DefaultValue = -1)]
+        [IntegerValidator(MinValue = -1)]
+        public int ThreadsPerCore
+        {
+            get { return (int)this["threadsPerCore"]; }
+            set { this["threadsPerCore"] = value; }
+        }
+
         public static void TypeValidator(object value)
         {
             var type = (Type)value;
@@ -2,8 +2,10 @@
 using System.Collections.Generic;
 using System.ComponentModel.Composition;
 using System.ComponentModel.Composition.Hosting;
+using System.ComponentModel.Composition.Primitives;
 using System.Linq;
 using System.Threading;
+using System.Threading.Tasks;
 
 using BitMaker.Utils;
 
@@ -18,6 +20,16 @@ namespace BitMaker.Miner
 
         static readonly TimeSpan STATISTICS_UPDATE = TimeSpan.FromSeconds(1);
         static readonly TimeSpan STATISTICS_DELAY = TimeSpan.FromSeconds(6);
+        static readonly TimeSpan SAMPLE_WARMUP = TimeSpan.FromSeconds(1);
+        static readonly TimeSpan SAMPLE_DURATION = TimeSpan.FromSeconds(4);
+        static readonly TimeSpan HEDGE_DELAY_MIN = TimeSpan.FromMilliseconds(250);
+        static readonly TimeSpan HEDGE_DELAY_MAX = TimeSpan.FromSeconds(5);
+        static readonly TimeSpan SPARE_WORK_AGE = TimeSpan.FromSeconds(30);
+        const int SPARE_WORK_COUNT = 8;
+        static readonly TimeSpan SCHEDULE_PERIOD = TimeSpan.FromSeconds(30);
+        const long SCHEDULE_GRANULE = 65536;
+        const long SCHEDULE_INITIAL = 1L << 24;
+        const double RATE_WEIGHT = 0.2;
 
         /// <summary>
         /// Gets the current time in nano-seconds.
@@ -31,7 +43,7 @@ namespace BitMaker.Miner
         /// <summary>
         /// Contains MEF integrated components.
         /// </summary>
-        CompositionContainer container = new CompositionContainer(new ApplicationCatalog());
+        CompositionContainer container;
 
         object syncRoot = new object();
 
@@ -55,35 +67,72 @@ namespace BitMaker.Miner
         /// </summary>
         List<Pool> pools;
 
+        /// <summary>
+        /// Work delivered by hedged requests after another pool had already answered, with the time it arrived.
+        /// </summary>
+        Queue<Tuple<Work, long>> spareWork = new Queue<Tuple<Work, long>>();
+
+        /// <summary>
+        /// Work whose nonce range is being handed out to the miners in portions, and the next nonce to hand out.
+        /// </summary>
+        Work scheduledWork;
+        long scheduledNonce;
+        object scheduleLock = new object();
+
+        /// <summary>
+        /// Miners being stopped, whose requests for work are abandoned so they can finish stopping even while no pool
+        /// delivers work. Also used to wake those requests.
+        /// </summary>
+        HashSet<IMiner> stoppingMiners = new HashSet<IMiner>();
+
         /// <summary>
         /// Timer that fires to collect statistics.
         /// </summary>
         System.Timers.Timer statisticsTimer;
 
+        /// <summary>
+        /// Hash counters and calibrated rates of every known miner. Built before any miner is started and replaced as a
+        /// whole, so it can be read by reporting miners without locking.
+        /// </summary>
+        Dictionary<IMiner, MinerStatistics> minerStatistics = new Dictionary<IMiner, MinerStatistics>();
+
         long startTime;
         long hashCount;
+
+        /// <summary>
+        /// Number of hashes generated by miners on processors, which the energy counters account for.
+        /// </summary>
+        long cpuHashCount;
         long previousHashCount;
         double previousAdjustedHashCount;
         long previousAdjustedStartTime;
         double hashesPerSecond;
 
         /// <summary>
-        /// Available miner factories.
+        /// Available miner factories, described by their metadata. A factory is only constructed once it is selected
+        /// for a kind of device.
         /// </summary>
         [ImportMany]
-        public IEnumerable<IMinerFactory> MinerFactories { get; set; }
+        public IEnumerable<Lazy<IMinerFactory, IMinerFactoryMetadata>> MinerFactories { get; set; }
 
         /// <summary>
         /// Currently executing miners.
         /// </summary>
         public List<IMiner> Miners { get; private set; }
 
+        /// <summary>
+        /// Copy of <see cref="P:Miners"/>, replaced as a whole whenever a miner is started or stopped, so it can be
+        /// read by miners requesting work without locking.
+        /// </summary>
+        IMiner[] runningMiners = new IMiner[0];
+
         /// <summary>
         /// Initializes a new instance.
         /// </summary>
         public MinerHost()
         {
             // import available plugins
+            container = new CompositionContainer(CreateCatalog(ConfigurationSection.GetDefaultSection()));
             container.ComposeExportedValue<IMinerContext>(this);
             container.SatisfyImportsOnce(this);
 
@@ -97,6 +146,21 @@ namespace BitMaker.Miner
             mainThread.Start();
         }
 
+        /// <summary>
+        /// Creates the catalog from which miner factories are imported. Configured miner factories act as an explicit
+        /// manifest, so only their assemblies are loaded; otherwise every assembly in the application is scanned for
+        /// their metadata.
+        /// </summary>
+        /// <param name="cfg"></param>
+        /// <returns></returns>
+        static ComposablePartCatalog CreateCatalog(ConfigurationSection cfg)
+        {
+            if (cfg.Miners.Count > 0)
+                return new TypeCatalog(cfg.Miners.Select(i => i.Type));
+
+            return new ApplicationCatalog();
+        }
+
         /// <summary>
         /// Starts execution of the miners.
         /// </summary>
@@ -158,53 +222,94 @@ namespace BitMaker.Miner
                         .ToList();
                 }
 
-                // configured factories
-                var factories = MinerFactories;
-                if (cfg.Miners.Count > 0)
-                    factories = factories
-                        .Where(i => cfg.Miners.Any(j => j.Type.IsInstanceOfType(i)));
+                // resources, with the miners that can use them; processors come first, so that their miners start
+                // without waiting on the discovery of other devices
+                var devices = new List<DeviceMiners>();
+                minerStatistics = new Dictionary<IMiner, MinerStatistics>();
+                foreach (MinerDeviceKind kind in Enum.GetValues(typeof(MinerDeviceKind)))
+                {
+                    if (!run)
+                        break;
 
-                // resources, with the miner factories that can use them
-                var minersByDevice = factories
-                    .SelectMany(i => i.Miners
-                        .Select(j => new
+                    var kindDevices = SelectFactories(kind, cfg.Miners.Count > 0)
+                        .SelectMany(i => i.Miners)
+                        .GroupBy(i => i.Device)
+                        .Select(i => new DeviceMiners()
                         {
-                            Factory = i,
-                            Miner = j,
-                            Device = j.Device,
-                        }))
-                    .GroupBy(i => i.Device)
-                    .Select(i => new
+                            Device = i.Key,
+                            Kind = kind,
+                            Miners = i.ToList(),
+                        })
+                        .ToList();
+
+                    // every miner has a counter before any of them can report hashes
+                    var statistics = new Dictionary<IMiner, MinerStatistics>(minerStatistics);
+                    foreach (var miner in kindDevices.SelectMany(i => i.Miners))
+                        statistics[miner] = new MinerStatistics() { Kind = kind };
+                    minerStatistics = statistics;
+
+                    // for each resource, start the appropriate miner
+                    foreach (var device in kindDevices)
                     {
-                        Device = i.Key,
-                        Miners = i
-                            .Select(j => j.Miner)
-                            .ToList(),
-                    })
-                    .ToList();
+                        // calibrate each candidate miner if there is a choice to be made
+                        if (device.Miners.Count > 1)
+                            foreach (var miner in device.Miners)
+                                if (run)
+                                    SampleMiner(miner);
+
+                        // break out prematurely if told to stop
+                        if (!run)
+                            break;
+
+                        // start production miner with the top sampled hash rate, or first
+                        StartMiner(device, device.Miners
+                            .OrderByDescending(i => minerStatistics[i].HashesPerSecond)
+                            .First());
+                        devices.Add(device);
+                    }
+                }
 
-                // for each resource, start the appropriate miner
-                foreach (var deviceMiners in minersByDevice)
+                // correlate hashes with energy, and under the efficiency policy choose the kernel and number of
+                // devices to run by it
+                var efficiency = new EfficiencyController(new RaplEnergySource(), () => Interlocked.Read(ref cpuHashCount), cfg.EfficiencyPolicy);
+                if (!efficiency.Energy.IsAvailable)
+                    Console.WriteLine("ENERGY  : counters unavailable, running for {0}", EfficiencyPolicy.Throughput);
+                else if (run && efficiency.Policy == EfficiencyPolicy.Efficiency)
+                    Optimize(devices, efficiency);
+
+                // wait until we're told to terminate, periodically measuring the running miners and revisiting the
+                // miner chosen for each device, each on its own interval
+                var efficiencyTime = Now() + (long)cfg.EfficiencyInterval.TotalMilliseconds;
+                var reselectTime = Now() + (long)cfg.ReselectInterval.TotalMilliseconds;
+                while (run)
                 {
-                    // select miner with the top number of sample hashes, or first
-                    var miner = deviceMiners.Miners.Count == 1 ? deviceMiners.Miners[0] : deviceMiners.Miners
-                        .Select(i => new { Miner = i, Hashes = run ? SampleMiner(i) : 0 })
-                        .OrderByDescending(i => i.Hashes)
-                        .Select(i => i.Miner)
-                        .FirstOrDefault();
-
-                    // break out prematurely if told to stop
-                    if (!run)
-                        break;
+                    lock (syncRoot)
+                        if (run)
+                            Monitor.Wait(syncRoot, 5000);
 
-                    // start production miner
-                    StartMiner(miner);
-                }
+                    if (run && efficiency.Energy.IsAvailable && cfg.EfficiencyInterval > TimeSpan.Zero && Now() >= efficiencyTime)
+                    {
+                        // report the hash rate and power since the previous interval
+                        EfficiencyController.Report(efficiency.Sample("running"));
 
-                // wait until we're told to terminate
-                lock (syncRoot)
-                    while (run)
-                        Monitor.Wait(syncRoot, 5000);
+                        // the efficiency policy chooses the kernel of each device itself
+                        if (efficiency.Policy == EfficiencyPolicy.Efficiency)
+                            Optimize(devices, efficiency);
+
+                        efficiencyTime = Now() + (long)cfg.EfficiencyInterval.TotalMilliseconds;
+                    }
+
+                    if (run && cfg.ReselectInterval > TimeSpan.Zero && Now() >= reselectTime)
+                    {
+                        // kernels chosen by the efficiency policy are left alone until it measures them again
+                        if (!efficiency.Energy.IsAvailable || efficiency.Policy != EfficiencyPolicy.Efficiency)
+                            foreach (var device in devices)
+                                if (run)
+                                    Reselect(device, cfg.ReselectThreshold);
+
+                        reselectTime = Now() + (long)cfg.ReselectInterval.TotalMilliseconds;
+                    }
+                }
 
                 // shut down each executing miner
                 while (Miners.Any())
@@ -216,6 +321,12 @@ namespace BitMaker.Miner
                     statisticsTimer.Dispose();
                     statisticsTimer = null;
 
+                    // drop work from pools about to be disposed
+                    lock (spareWork)
+                        spareWork.Clear();
+                    lock (scheduleLock)
+                        scheduledWork = null;
+
                     // dispose of the pools
                     if (pools != null)
                     {
@@ -231,6 +342,52 @@ namespace BitMaker.Miner
             }
         }
 
+        /// <summary>
+        /// Constructs the factories of the given kind of device whose instruction set the processor supports. If
+        /// factories are configured, each of them is used and their miners are sampled against each other; otherwise
+        /// only the most preferred factory which exposes any miners is used, and the rest are never constructed.
+        /// </summary>
+        /// <param name="kind"></param>
+        /// <param name="configured"></param>
+        /// <returns></returns>
+        IEnumerable<IMinerFactory> SelectFactories(MinerDeviceKind kind, bool configured)
+        {
+            var candidates = MinerFactories
+                .Where(i => i.Metadata.Device == kind)
+                .Where(i => ProcessorFeatures.IsSupported(i.Metadata.Requires))
+                .OrderByDescending(i => i.Metadata.Priority);
+
+            foreach (var candidate in candidates)
+            {
+                var factory = CreateFactory(candidate);
+                if (factory == null || !factory.Miners.Any())
+                    continue;
+
+                yield return factory;
+
+                if (!configured)
+                    yield break;
+            }
+        }
+
+        /// <summary>
+        /// Constructs the given factory, returning <c>null</c> if it cannot be, such as when its native code does not
+        /// load.
+        /// </summary>
+        /// <param name="factory"></param>
+        /// <returns></returns>
+        static IMinerFactory CreateFactory(Lazy<IMinerFactory, IMinerFactoryMetadata> factory)
+        {
+            try
+            {
+                return factory.Value;
+            }
+            catch (Exception)
+            {
+                return null;
+            }
+        }
+
         /// <summary>
         /// Starts a new miner.
         /// </summary>
@@ -239,17 +396,223 @@ namespace BitMaker.Miner
         void StartMiner(IMiner miner)
         {
             Miners.Add(miner);
+            runningMiners = Miners.ToArray();
             miner.Start();
         }
 
+        /// <summary>
+        /// Starts the given miner as the active miner of the device.
+        /// </summary>
+        /// <param name="device"></param>
+        /// <param name="miner"></param>
+        void StartMiner(DeviceMiners device, IMiner miner)
+        {
+            device.Active = miner;
+            device.ActiveHashCount = Interlocked.Read(ref minerStatistics[miner].HashCount);
+            device.ActiveStartTime = Now();
+
+            StartMiner(miner);
+        }
+
+        /// <summary>
+        /// Compares the live hash rate of the active miner of a device against the calibrated rates of its
+        /// alternatives, and switches the device over if an alternative is confirmed to be faster. Other devices
+        /// continue to run undisturbed. The active miner is stopped while the alternative is sampled, as both would
+        /// otherwise share the device and neither rate would be meaningful; for those few seconds the device runs the
+        /// alternative even if the sample then rejects it.
+        /// </summary>
+        /// <param name="device"></param>
+        /// <param name="threshold"></param>
+        void Reselect(DeviceMiners device, double threshold)
+        {
+            if (device.Active == null || device.Miners.Count < 2)
+                return;
+
+            var active = device.Active;
+            var activeStatistics = minerStatistics[active];
+
+            // live hash rate since the miner was started or last evaluated
+            var now = Now();
+            var hashCount = Interlocked.Read(ref activeStatistics.HashCount);
+            if (now <= device.ActiveStartTime)
+                return;
+
+            activeStatistics.HashesPerSecond = (double)(hashCount - device.ActiveHashCount) / (double)(now - device.ActiveStartTime) * 1000;
+            device.ActiveHashCount = hashCount;
+            device.ActiveStartTime = now;
+
+            // stay put unless the best alternative is ahead by more than the threshold
+            var candidate = device.Miners
+                .Where(i => i != active)
+                .OrderByDescending(i => minerStatistics[i].HashesPerSecond)
+                .First();
+            if (minerStatistics[candidate].HashesPerSecond <= activeStatistics.HashesPerSecond * (1 + threshold))
+                return;
+
+            // the miner submits any solution it has found before it finishes stopping
+            StopMiner(active);
+
+            // calibration may be stale, confirm the alternative under current conditions before committing to it
+            SampleMiner(candidate);
+            if (!run)
+                return;
+
+            if (minerStatistics[candidate].HashesPerSecond > activeStatistics.HashesPerSecond * (1 + threshold))
+            {
+                Console.WriteLine("RESELECT: {0,10} -> {1}", active.GetType().Name, candidate.GetType().Name);
+                StartMiner(device, candidate);
+            }
+            else
+                StartMiner(device, active);
+        }
+
+        /// <summary>
+        /// Makes the given miner the active miner of the device, stopping the device if <c>null</c>.
+        /// </summary>
+        /// <param name="device"></param>
+        /// <param name="miner"></param>
+        void Activate(DeviceMiners device, IMiner miner)
+        {
+            if (device.Active == miner)
+                return;
+
+            if (device.Active != null)
+                StopMiner(device.Active);
+            device.Active = null;
+
+            if (miner != null)
+                StartMiner(device, miner);
+        }
+
+        /// <summary>
+        /// Measures the hash rate and power of each kernel on an increasing number of the devices that can run it,
+        /// reports the resulting curve and runs the configuration preferred by the policy. Wider kernels can lower the
+        /// clock of the whole package, so the kernel and the number of devices are chosen together. Only processors
+        /// are considered, as the energy counters cover the processor packages alone, and only kernels that run on
+        /// more than one of them; processors the kernel cannot run on keep their miner, as do other devices.
+        /// </summary>
+        /// <param name="devices"></param>
+        /// <param name="efficiency"></param>
+        void Optimize(List<DeviceMiners> devices, EfficiencyController efficiency)
+        {
+            var curve = new List<EfficiencySample>();
+            var configurations = new Dictionary<EfficiencySample, List<Tuple<DeviceMiners, IMiner>>>();
+
+            // miners running before the measurements, which those devices return to when not part of a configuration
+            var cpus = devices
+                .Where(i => i.Kind == MinerDeviceKind.Cpu)
+                .ToList();
+            var previous = cpus
+                .Select(i => Tuple.Create(i, i.Active))
+                .ToList();
+
+            var kernels = cpus
+                .SelectMany(i => i.Miners)
+                .GroupBy(i => i.GetType())
+                .Where(i => i.Count() > 1);
+
+            foreach (var kernel in kernels)
+            {
+                // devices in the order they are brought into use, with the miner of the kernel on each
+                var miners = cpus
+                    .Select(i => Tuple.Create(i, i.Miners.FirstOrDefault(j => j.GetType() == kernel.Key)))
+                    .Where(i => i.Item2 != null)
+                    .ToList();
+
+                foreach (var count in GetDeviceCounts(miners.Count))
+                {
+                    if (!run)
+                        return;
+
+                    var configuration = miners
+                        .Select((i, j) => Tuple.Create(i.Item1, j < count ? i.Item2 : null))
+                        .Concat(previous.Where(i => !miners.Any(j => j.Item1 == i.Item1)))
+                        .ToList();
+                    foreach (var i in configuration)
+                        Activate(i.Item1, i.Item2);
+
+                    // allow the miners a moment to retrieve work before measuring
+                    Thread.Sleep(SAMPLE_WARMUP);
+                    var sample = efficiency.Measure(string.Format("{0} x{1}", kernel.Key.Name, count), SAMPLE_DURATION);
+                    EfficiencyController.Report(sample);
+
+                    curve.Add(sample);
+                    configurations[sample] = configuration;
+                }
+            }
+
+            var best = efficiency.Select(curve);
+            if (best != null && run)
+            {
+                Console.WriteLine("ENERGY  : running {0} for {1}", best.Name, efficiency.Policy);
+                foreach (var i in configurations[best])
+                    Activate(i.Item1, i.Item2);
+            }
+            else if (run)
+                foreach (var i in previous)
+                    Activate(i.Item1, i.Item2);
+
+            efficiency.Reset();
+        }
+
+        /// <summary>
+        /// Gets the numbers of devices to measure out of <paramref name="count"/>: each of them for a few devices,
+        /// doubling for many.
+        /// </summary>
+        /// <param name="count"></param>
+        /// <returns></returns>
+        static IEnumerable<int> GetDeviceCounts(int count)
+        {
+            for (int i = 1; i < count; i = count <= 8 ? i + 1 : i * 2)
+                yield return i;
+
+            yield return count;
+        }
+
         /// <summary>
         /// Stops the given miner.
         /// </summary>
         /// <param name="miner"></param>
         void StopMiner(IMiner miner)
         {
-            miner.Stop();
+            HaltMiner(miner);
             Miners.Remove(miner);
+            runningMiners = Miners.ToArray();
+        }
+
+        /// <summary>
+        /// Stops execution of the given miner, abandoning any request for work it is blocked on.
+        /// </summary>
+        /// <param name="miner"></param>
+        void HaltMiner(IMiner miner)
+        {
+            lock (stoppingMiners)
+            {
+                stoppingMiners.Add(miner);
+                Monitor.PulseAll(stoppingMiners);
+            }
+
+            try
+            {
+                miner.Stop();
+            }
+            finally
+            {
+                lock (stoppingMiners)
+                    stoppingMiners.Remove(miner);
+            }
+        }
+
+        /// <summary>
+        /// Returns <c>true</c> if work should still be fetched for the given miner: the host is running and the miner
+        /// is not being stopped.
+        /// </summary>
+        /// <param name="miner"></param>
+        /// <returns></returns>
+        bool IsWanted(IMiner miner)
+        {
+            lock (stoppingMiners)
+                return run && !stoppingMiners.Contains(miner);
         }
 
         /// <summary>
@@ -288,37 +651,251 @@ namespace BitMaker.Miner
         }
 
         /// <summary>
-        /// Gets a new unit of work.
+        /// Gets a new unit of work: a portion of the nonce range of the current work sized to the hash rate of the
+        /// miner, so that miners of different speeds share the range of a single work.
         /// </summary>
         /// <returns></returns>
         public Work GetWork(IMiner miner, string comment)
         {
-            // continue attempting to get work until we are told to shut down
-            while (run)
+            while (IsWanted(miner))
             {
-                // attempt each available pool
-                foreach (var pool in pools)
-                {
-                    // bail out of inner loop
-                    if (!run)
-                        break;
+                // portion of the current work
+                var work = ScheduleWork(miner);
+                if (work != null)
+                    return work;
 
-                    try
+                // current work is exhausted or stale, fetch the next
+                work = FetchWork(miner, comment);
+                if (work == null)
+                    break;
+
+                lock (scheduleLock)
+                {
+                    // another miner may have replaced it in the meantime, keep ours for later
+                    if (IsSchedulable(scheduledWork))
+                        AddSpareWork(work);
+                    else
                     {
-                        // ask the pool for work, continue if it can't deliver
-                        Work work = pool.GetWorkRpc(miner, comment);
-                        if (work != null)
-                            return work;
+                        scheduledWork = work;
+                        scheduledNonce = 0;
                     }
-                    catch (Exception)
-                    {
+                }
+            }
 
-                    }
+            return null;
+        }
+
+        /// <summary>
+        /// Returns <c>true</c> if the scheduled work is current and has nonces left to hand out.
+        /// </summary>
+        /// <param name="work"></param>
+        /// <returns></returns>
+        bool IsSchedulable(Work work)
+        {
+            return work != null &&
+                !work.IsStale &&
+                scheduledNonce < Work.NONCE_SPACE;
+        }
+
+        /// <summary>
+        /// Hands out the next portion of the scheduled work to the given miner, or returns <c>null</c> if there is
+        /// none left.
+        /// </summary>
+        /// <param name="miner"></param>
+        /// <returns></returns>
+        Work ScheduleWork(IMiner miner)
+        {
+            lock (scheduleLock)
+            {
+                if (!IsSchedulable(scheduledWork))
+                    return null;
+
+                var count = ScheduleCount(miner, Work.NONCE_SPACE - scheduledNonce);
+                var work = scheduledWork.Split((uint)scheduledNonce, count);
+                scheduledNonce += count;
+                return work;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of nonces to hand out to the given miner: enough to keep it busy for the schedule period,
+        /// but no more than its share of the remaining range by hash rate among the running miners, so that they all
+        /// finish the range at about the same time. Miners which are not running, such as the alternatives of a
+        /// device, keep their calibrated rates but take no share.
+        /// </summary>
+        /// <param name="miner"></param>
+        /// <param name="remaining"></param>
+        /// <returns></returns>
+        long ScheduleCount(IMiner miner, long remaining)
+        {
+            var allStatistics = minerStatistics;
+
+            MinerStatistics statistics;
+            var rate = allStatistics.TryGetValue(miner, out statistics) ? statistics.Rate : 0;
+
+            var totalRate = 0.0;
+            foreach (var running in runningMiners)
+                if (allStatistics.TryGetValue(running, out statistics))
+                    totalRate += statistics.Rate;
+
+            // rate not yet known, hand out a small portion to measure it
+            var count = SCHEDULE_INITIAL;
+            if (rate > 0 && totalRate > 0)
+                count = (long)Math.Min(rate * SCHEDULE_PERIOD.TotalSeconds, remaining * (rate / totalRate));
+
+            // miners search whole granules, and there's no point leaving less than one behind
+            count = Math.Max(count / SCHEDULE_GRANULE, 1) * SCHEDULE_GRANULE;
+            if (remaining - count < SCHEDULE_GRANULE)
+                count = remaining;
+
+            return Math.Min(count, remaining);
+        }
+
+        /// <summary>
+        /// Fetches a new work from the pools.
+        /// </summary>
+        /// <returns></returns>
+        Work FetchWork(IMiner miner, string comment)
+        {
+            // continue attempting to get work until we are told to shut down or the miner is stopped
+            while (IsWanted(miner))
+            {
+                // work left over from an earlier hedged request
+                var work = GetSpareWork();
+                if (work != null)
+                    return work;
+
+                // attempt the available pools, healthiest first
+                var pools = this.pools;
+                if (pools != null)
+                {
+                    work = GetWork(pools.OrderBy(i => i.Cost).ToList(), miner, comment);
+                    if (work != null)
+                        return work;
                 }
 
-                // wait for 5 seconds before trying again
-                Thread.Sleep(5000);
+                // wait for 5 seconds before trying again, bailing out if the miner is told to stop
+                lock (stoppingMiners)
+                    if (run && !stoppingMiners.Contains(miner))
+                        Monitor.Wait(stoppingMiners, 5000);
+            }
+
+            return null;
+        }
+
+        /// <summary>
+        /// Requests work from the given pools in order. If a request takes longer than its pool usually does, or
+        /// fails, the request to the next pool is issued without abandoning the outstanding ones; the first work to
+        /// arrive is returned. Returns <c>null</c> if no pool delivers work.
+        /// </summary>
+        /// <param name="pools"></param>
+        /// <param name="miner"></param>
+        /// <param name="comment"></param>
+        /// <returns></returns>
+        Work GetWork(List<Pool> pools, IMiner miner, string comment)
+        {
+            var pending = new List<Task<Work>>();
+            var next = 0;
+
+            while (IsWanted(miner))
+            {
+                // issue request to the next pool
+                if (next < pools.Count)
+                {
+                    var pool = pools[next++];
+                    pending.Add(Task.Factory.StartNew(() => GetWork(pool, miner, comment)));
+                }
+
+                // every request failed
+                if (pending.Count == 0)
+                    return null;
+
+                // wait for a request to finish, hedging with the next pool if the last one is slow
+                var delay = next < pools.Count ? HedgeDelay(pools[next - 1]) : TimeSpan.FromSeconds(1);
+                var index = Task.WaitAny(pending.ToArray(), delay);
+                if (index < 0)
+                    continue;
+
+                var task = pending[index];
+                pending.RemoveAt(index);
+
+                // first work to arrive is used, any arriving later is kept for the next request
+                if (task.Result != null)
+                {
+                    foreach (var i in pending)
+                        i.ContinueWith(t => AddSpareWork(t.Result));
+
+                    return task.Result;
+                }
+            }
+
+            return null;
+        }
+
+        /// <summary>
+        /// Requests work from a single pool, returning <c>null</c> if it fails.
+        /// </summary>
+        /// <param name="pool"></param>
+        /// <param name="miner"></param>
+        /// <param name="comment"></param>
+        /// <returns></returns>
+        static Work GetWork(Pool pool, IMiner miner, string comment)
+        {
+            try
+            {
+                return pool.GetWorkRpc(miner, comment);
             }
+            catch (Exception)
+            {
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Gets the time to wait on a request to the given pool before hedging it with a request to another pool.
+        /// </summary>
+        /// <param name="pool"></param>
+        /// <returns></returns>
+        static TimeSpan HedgeDelay(Pool pool)
+        {
+            var delay = TimeSpan.FromTicks(pool.Latency.Ticks * 2);
+            if (delay < HEDGE_DELAY_MIN)
+                return HEDGE_DELAY_MIN;
+            if (delay > HEDGE_DELAY_MAX)
+                return HEDGE_DELAY_MAX;
+            return delay;
+        }
+
+        /// <summary>
+        /// Keeps work that arrived after it was needed.
+        /// </summary>
+        /// <param name="work"></param>
+        void AddSpareWork(Work work)
+        {
+            if (work == null || !run)
+                return;
+
+            lock (spareWork)
+                if (spareWork.Count < SPARE_WORK_COUNT)
+                    spareWork.Enqueue(Tuple.Create(work, Now()));
+        }
+
+        /// <summary>
+        /// Gets previously retrieved work that is still current, or <c>null</c>.
+        /// </summary>
+        /// <returns></returns>
+        Work GetSpareWork()
+        {
+            lock (spareWork)
+                while (spareWork.Count > 0)
+                {
+                    var spare = spareWork.Dequeue();
+                    var work = spare.Item1;
+
+                    // discard work that is too old or was issued for a previous block
+                    if (Now() - spare.Item2 < SPARE_WORK_AGE.TotalMilliseconds && !work.IsStale)
+                        return work;
+                }
 
             return null;
         }
@@ -345,6 +922,14 @@ namespace BitMaker.Miner
         public void ReportHashes(IMiner plugin, long count)
         {
             Interlocked.Add(ref hashCount, count);
+
+            MinerStatistics statistics;
+            if (minerStatistics.TryGetValue(plugin, out statistics))
+            {
+                Interlocked.Add(ref statistics.HashCount, count);
+                if (statistics.Kind == MinerDeviceKind.Cpu)
+                    Interlocked.Add(ref cpuHashCount, count);
+            }
         }
 
         /// <summary>
@@ -369,68 +954,97 @@ namespace BitMaker.Miner
                 previousAdjustedStartTime = now - 1;
             }
 
+            // live hash rate of each miner, which sizes the portions of work handed out to it
+            foreach (var statistics in minerStatistics.Values)
+            {
+                var count = Interlocked.Read(ref statistics.HashCount);
+                if (statistics.RateTime > 0 && now > statistics.RateTime)
+                {
+                    var rate = (double)(count - statistics.RateHashCount) / (double)(now - statistics.RateTime) * 1000;
+                    statistics.Rate += (rate - statistics.Rate) * RATE_WEIGHT;
+                }
+
+                statistics.RateHashCount = count;
+                statistics.RateTime = now;
+            }
+
             statisticsTimer.Start();
         }
 
         /// <summary>
-        /// Context to be used to sample the hash rate of a miner.
+        /// Hash statistics of a single miner.
         /// </summary>
-        class SampleMinerContext : IMinerContext
+        class MinerStatistics
         {
 
-            MinerHost host;
-            internal long hashCount;
+            /// <summary>
+            /// Kind of device the miner runs on.
+            /// </summary>
+            public MinerDeviceKind Kind;
 
             /// <summary>
-            /// Initializes a new instance.
+            /// Total number of hashes reported by the miner.
             /// </summary>
-            /// <param name="host"></param>
-            public SampleMinerContext(MinerHost host)
-            {
-                this.host = host;
-            }
+            public long HashCount;
 
-            public Work GetWork(IMiner miner, string comment)
-            {
-                return host.GetWork(miner, comment);
-            }
+            /// <summary>
+            /// Most recently measured hash rate of the miner.
+            /// </summary>
+            public double HashesPerSecond;
 
-            public bool SubmitWork(IMiner miner, Work work, string comment)
-            {
-                return host.SubmitWork(miner, work, comment);
-            }
+            /// <summary>
+            /// Moving average of the live hash rate of the miner, with the hash count and time it was last updated.
+            /// </summary>
+            public double Rate;
+            public long RateHashCount;
+            public long RateTime;
 
-            public void ReportHashes(IMiner plugin, long count)
-            {
-                // keep our own counter of hashes
-                Interlocked.Add(ref hashCount, count);
+        }
 
-                // report to main host, these afterall do count for something
-                host.ReportHashes(plugin, count);
-            }
+        /// <summary>
+        /// Device with the miners that can use it.
+        /// </summary>
+        class DeviceMiners
+        {
+
+            public MinerDevice Device;
+
+            public MinerDeviceKind Kind;
+
+            public List<IMiner> Miners;
+
+            /// <summary>
+            /// Miner currently running on the device.
+            /// </summary>
+            public IMiner Active;
+
+            /// <summary>
+            /// Hash count and time at which the active miner was started or last evaluated.
+            /// </summary>
+            public long ActiveHashCount;
+            public long ActiveStartTime;
 
         }
 
         /// <summary>
-        /// Starts a miner for a predetermined amount of time and records it's hash count.
+        /// Starts a miner for a predetermined amount of time and records it's hash rate.
         /// </summary>
-        long SampleMiner(IMiner miner)
+        void SampleMiner(IMiner miner)
         {
-            // context for sample run of miner
-            var ctx = new SampleMinerContext(this);
+            var statistics = minerStatistics[miner];
 
-            // begin the miner
+            // begin the miner, and allow it a moment to retrieve work
             miner.Start();
+            Thread.Sleep(SAMPLE_WARMUP);
 
             // allow the miner to work for a few seconds
-            Thread.Sleep(5000);
+            var hashCount = Interlocked.Read(ref statistics.HashCount);
+            var time = Now();
+            Thread.Sleep(SAMPLE_DURATION);
 
             // pull the hash count immediately before stopping
-            var hashCount = ctx.hashCount;
-            StopMiner(miner);
-
-            // return the hash count generated by the miner in the alloted time
-            return hashCount;
+            statistics.HashesPerSecond = (double)(Interlocked.Read(ref statistics.HashCount) - hashCount) / (double)(Now() - time) * 1000;
+            HaltMiner(miner);
         }
 
     }
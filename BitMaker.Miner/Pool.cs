@@ -1,8 +1,12 @@
 ﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
 using System.IO;
 using System.Linq;
 using System.Net;
+using System.Runtime.InteropServices;
 using System.Threading;
+using System.Threading.Tasks;
 using System.Web;
 
 using Jayrock.Json;
@@ -25,9 +29,26 @@ namespace BitMaker.Miner
         static int refreshPeriod = (int)TimeSpan.FromSeconds(15).TotalMilliseconds;
 
         /// <summary>
-        /// Keeps the refresh thread alive.
+        /// Time after which an unanswered long-poll request is abandoned and reissued.
         /// </summary>
-        bool run = true;
+        static readonly TimeSpan LONG_POLL_TIMEOUT = TimeSpan.FromSeconds(60);
+
+        /// <summary>
+        /// Number of superseded previous block hashes remembered, to recognize late responses for an old block.
+        /// </summary>
+        const int RETIRED_BLOCK_COUNT = 4;
+
+        /// <summary>
+        /// Weight given to the most recent request when updating the health averages.
+        /// </summary>
+        const double HEALTH_WEIGHT = 0.2;
+
+        object syncRoot = new object();
+
+        /// <summary>
+        /// Signals the refresh thread to stop, aborting any outstanding long-poll request.
+        /// </summary>
+        CancellationTokenSource cts = new CancellationTokenSource();
 
         /// <summary>
         /// Base url of the pool.
@@ -39,6 +60,18 @@ namespace BitMaker.Miner
         /// </summary>
         public uint CurrentBlockNumber { get; private set; }
 
+        /// <summary>
+        /// Counter incremented whenever the pool moves on to a new block. Kept in unmanaged memory so native search
+        /// loops can watch it directly.
+        /// </summary>
+        IntPtr generation;
+
+        /// <summary>
+        /// Previous block hash of the current block, and those it superseded.
+        /// </summary>
+        string previousHash;
+        Queue<string> retiredHashes = new Queue<string>();
+
         /// <summary>
         /// Thread that pulls current block.
         /// </summary>
@@ -49,6 +82,59 @@ namespace BitMaker.Miner
         /// </summary>
         Uri longPollUrl;
 
+        /// <summary>
+        /// Moving averages of the duration, in milliseconds, and failure rate of 'getwork' requests.
+        /// </summary>
+        double latency;
+        double errorRate;
+
+        /// <summary>
+        /// Gets the moving average of the time taken by the pool to answer a 'getwork' request.
+        /// </summary>
+        public TimeSpan Latency
+        {
+            get { return TimeSpan.FromMilliseconds(latency); }
+        }
+
+        /// <summary>
+        /// Gets the moving average of the fraction of 'getwork' requests that failed to deliver work.
+        /// </summary>
+        public double ErrorRate
+        {
+            get { return errorRate; }
+        }
+
+        /// <summary>
+        /// Gets the expected time, in milliseconds, to obtain work from the pool given its latency and error rate.
+        /// Lower is healthier.
+        /// </summary>
+        public double Cost
+        {
+            get
+            {
+                lock (syncRoot)
+                    return latency / Math.Max(1.0 - errorRate, 0.01);
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of times the pool has moved on to a new block. Work issued under an earlier generation is
+        /// stale.
+        /// </summary>
+        public int Generation
+        {
+            get { return Marshal.ReadInt32(generation); }
+        }
+
+        /// <summary>
+        /// Gets the address of the generation counter, for native search loops to compare against the generation of
+        /// their work.
+        /// </summary>
+        public IntPtr GenerationPtr
+        {
+            get { return generation; }
+        }
+
         /// <summary>
         /// Initializes a new instance.
         /// </summary>
@@ -59,6 +145,9 @@ namespace BitMaker.Miner
 
             CurrentBlockNumber = 0;
 
+            generation = Marshal.AllocHGlobal(sizeof(int));
+            Marshal.WriteInt32(generation, 0);
+
             // periodically check latest block number
             refreshThread = new Thread(RefreshThreadMain);
             refreshThread.Start();
@@ -69,25 +158,71 @@ namespace BitMaker.Miner
         /// </summary>
         void RefreshThreadMain()
         {
-            while (run)
+            while (!cts.IsCancellationRequested)
             {
                 try
                 {
                     if (longPollUrl == null)
                     {
                         GetWorkRpc(null, null);
-                        Thread.Sleep(refreshPeriod);
+                        cts.Token.WaitHandle.WaitOne(refreshPeriod);
                     }
                     else
                         GetWorkLp(null, null);
                 }
                 catch (Exception)
                 {
-                    Thread.Sleep(5000);
+                    cts.Token.WaitHandle.WaitOne(5000);
                 }
             }
         }
 
+        /// <summary>
+        /// Moves on to a new block, making all outstanding work stale.
+        /// </summary>
+        internal unsafe void Advance()
+        {
+            Interlocked.Increment(ref *(int*)generation);
+        }
+
+        /// <summary>
+        /// Records the block of newly received work, advancing the generation if it is a new block. Returns the
+        /// generation the work belongs to, which is already stale if the work is for a block that was superseded.
+        /// </summary>
+        /// <param name="blockNumber"></param>
+        /// <param name="header"></param>
+        /// <returns></returns>
+        int UpdateBlock(uint blockNumber, byte[] header)
+        {
+            var hash = Memory.Encode(header.Skip(4).Take(32).ToArray());
+
+            lock (syncRoot)
+            {
+                // late response to a request issued before the block changed
+                if (retiredHashes.Contains(hash))
+                    return Generation - 1;
+
+                if (hash != previousHash || blockNumber != CurrentBlockNumber)
+                {
+                    if (previousHash != null && hash != previousHash)
+                    {
+                        retiredHashes.Enqueue(previousHash);
+                        if (retiredHashes.Count > RETIRED_BLOCK_COUNT)
+                            retiredHashes.Dequeue();
+                    }
+
+                    // first block seen is not a change
+                    if (previousHash != null)
+                        Advance();
+
+                    previousHash = hash;
+                    CurrentBlockNumber = blockNumber;
+                }
+
+                return Generation;
+            }
+        }
+
         /// <summary>
         /// Opens a web request.
         /// </summary>
@@ -156,10 +291,10 @@ namespace BitMaker.Miner
         /// <returns></returns>
         Work ParseGetWork(WebResponse webResponse)
         {
-            // obtain and update current block number
+            // obtain current block number, recorded along with the work
             uint blockNumber = 0;
             if (webResponse.Headers["X-Blocknum"] != null)
-                CurrentBlockNumber = blockNumber = uint.Parse(webResponse.Headers["X-Blocknum"]);
+                blockNumber = uint.Parse(webResponse.Headers["X-Blocknum"]);
 
             // parse and update long poll url value if present
             var longPollUrlStr = webResponse.Headers["X-Long-Polling"];
@@ -220,11 +355,12 @@ namespace BitMaker.Miner
                 if (target.Length != 32)
                     throw new InvalidDataException("Received target is not valid.");
 
-                // generate new work instance
+                // generate new work instance, as soon as it arrives a new block makes outstanding work stale
                 var work = new Work()
                 {
                     Pool = this,
                     BlockNumber = blockNumber,
+                    Generation = UpdateBlock(blockNumber, header),
                     Header = header,
                     Target = target,
                 };
@@ -237,10 +373,46 @@ namespace BitMaker.Miner
         }
 
         /// <summary>
-        /// Invokes the 'getwork' JSON method and parses the result into a new <see cref="T:Work"/> instance.
+        /// Records the outcome of a 'getwork' request in the health averages.
+        /// </summary>
+        /// <param name="elapsed"></param>
+        /// <param name="success"></param>
+        void RecordRequest(TimeSpan elapsed, bool success)
+        {
+            lock (syncRoot)
+            {
+                latency += (elapsed.TotalMilliseconds - latency) * HEALTH_WEIGHT;
+                errorRate += ((success ? 0.0 : 1.0) - errorRate) * HEALTH_WEIGHT;
+            }
+        }
+
+        /// <summary>
+        /// Invokes the 'getwork' JSON method and parses the result into a new <see cref="T:Work"/> instance. The
+        /// outcome is recorded in the health of the pool.
         /// </summary>
         /// <returns></returns>
         public Work GetWorkRpc(IMiner miner, string comment)
+        {
+            var stopwatch = Stopwatch.StartNew();
+
+            try
+            {
+                var work = InvokeGetWork(miner, comment);
+                RecordRequest(stopwatch.Elapsed, work != null);
+                return work;
+            }
+            catch (Exception)
+            {
+                RecordRequest(stopwatch.Elapsed, false);
+                throw;
+            }
+        }
+
+        /// <summary>
+        /// Invokes the 'getwork' JSON method and parses the result into a new <see cref="T:Work"/> instance.
+        /// </summary>
+        /// <returns></returns>
+        Work InvokeGetWork(IMiner miner, string comment)
         {
             var req = OpenRpc(miner, comment);
             if (req == null)
@@ -266,7 +438,8 @@ namespace BitMaker.Miner
         }
 
         /// <summary>
-        /// Initiates a long-poll request for work.
+        /// Initiates a long-poll request for work. The response is parsed as soon as it arrives, so a new block is
+        /// picked up without delay.
         /// </summary>
         /// <param name="miner"></param>
         /// <param name="comment"></param>
@@ -277,25 +450,20 @@ namespace BitMaker.Miner
             if (req == null)
                 return null;
 
-            var asy = req.BeginGetResponse(null, null);
+            var response = Task<WebResponse>.Factory.FromAsync(req.BeginGetResponse, req.EndGetResponse, null)
+                .ContinueWith(t => ParseGetWork(t.Result), TaskContinuationOptions.ExecuteSynchronously);
 
-            // wait until we're told to shutdown, or we run out of time
-            var elapsed = 0;
-            while (run && elapsed < TimeSpan.FromSeconds(60).TotalMilliseconds)
+            // abort the request if we're told to shut down, or if it runs out of time
+            using (cts.Token.Register(req.Abort))
             {
-                asy.AsyncWaitHandle.WaitOne(1000);
-                elapsed += 1000;
-            }
+                if (!response.Wait(LONG_POLL_TIMEOUT))
+                {
+                    req.Abort();
+                    return null;
+                }
 
-            if (!asy.IsCompleted)
-            {
-                // if it never completed, abort it
-                req.Abort();
-                return null;
+                return response.Result;
             }
-            else
-                // otherwise parse the result
-                return ParseGetWork(req.EndGetResponse(asy));
         }
 
         /// <summary>
@@ -371,7 +539,7 @@ namespace BitMaker.Miner
         /// </summary>
         public void Dispose()
         {
-            run = false;
+            cts.Cancel();
 
             if (refreshThread != null)
             {
@@ -380,6 +548,15 @@ namespace BitMaker.Miner
             }
         }
 
+        /// <summary>
+        /// Releases the generation counter. Outstanding work refers to the pool, so once the pool is collected no
+        /// search loop can be watching the counter.
+        /// </summary>
+        ~Pool()
+        {
+            Marshal.FreeHGlobal(generation);
+        }
+
     }
 
 }
@@ -0,0 +1,98 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Runtime.InteropServices;
+
+namespace BitMaker.Miner
+{
+
+    /// <summary>
+    /// Reports the instruction sets of the processor, so that miner factories which cannot run are never constructed
+    /// and their native code never loaded.
+    /// </summary>
+    public static class ProcessorFeatures
+    {
+
+        const int PF_XMMI64_INSTRUCTIONS_AVAILABLE = 10;
+
+        [DllImport("kernel32.dll")]
+        static extern bool IsProcessorFeaturePresent(int feature);
+
+        /// <summary>
+        /// Flags of the first processor in /proc/cpuinfo, or <c>null</c> if they cannot be read.
+        /// </summary>
+        static readonly Lazy<HashSet<string>> cpuinfoFlags = new Lazy<HashSet<string>>(ReadCpuinfoFlags);
+
+        /// <summary>
+        /// Gets whether we are running on a Unix-like system.
+        /// </summary>
+        static bool IsUnix
+        {
+            get { return Environment.OSVersion.Platform == PlatformID.Unix || Environment.OSVersion.Platform == PlatformID.MacOSX; }
+        }
+
+        /// <summary>
+        /// Returns <c>false</c> if the processor is known not to support the given instruction set. Where support
+        /// cannot be determined, <c>true</c> is returned and the miners detect it themselves once constructed.
+        /// </summary>
+        /// <param name="set"></param>
+        /// <returns></returns>
+        public static bool IsSupported(InstructionSet set)
+        {
+            if (set == InstructionSet.None)
+                return true;
+
+            try
+            {
+                if (IsUnix)
+                {
+                    // the kernel clears the avx flag if it does not save the registers
+                    var flags = cpuinfoFlags.Value;
+                    if (flags == null)
+                        return true;
+
+                    switch (set)
+                    {
+                        case InstructionSet.Sse2:
+                            return flags.Contains("sse2");
+                        case InstructionSet.Avx:
+                            return flags.Contains("avx");
+                    }
+                }
+                else if (set == InstructionSet.Sse2)
+                    return IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE);
+            }
+            catch (Exception)
+            {
+                // support unknown
+            }
+
+            // older versions of Windows do not report AVX
+            return true;
+        }
+
+        /// <summary>
+        /// Reads the flags of the first processor from /proc/cpuinfo.
+        /// </summary>
+        /// <returns></returns>
+        static HashSet<string> ReadCpuinfoFlags()
+        {
+            try
+            {
+                var line = File.ReadLines("/proc/cpuinfo")
+                    .FirstOrDefault(i => i.StartsWith("flags"));
+                if (line == null)
+                    return null;
+
+                return new HashSet<string>(line.Substring(line.IndexOf(':') + 1).Split(new[] { ' ' }, StringSplitOptions.RemoveEmptyEntries));
+            }
+            catch (Exception)
+            {
+                return null;
+            }
+        }
+
+    }
+
+}
@@ -0,0 +1,158 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+
+namespace BitMaker.Miner
+{
+
+    /// <summary>
+    /// Reads the energy consumed by the processor packages from the Linux powercap interface to the RAPL (running
+    /// average power limit) counters.
+    /// </summary>
+    public class RaplEnergySource : IEnergySource
+    {
+
+        const string POWERCAP_PATH = "/sys/class/powercap";
+
+        readonly object syncRoot = new object();
+
+        /// <summary>
+        /// Package domains, with their last reading.
+        /// </summary>
+        readonly List<Domain> domains;
+
+        /// <summary>
+        /// Energy accumulated across all domains.
+        /// </summary>
+        double joules;
+
+        /// <summary>
+        /// Initializes a new instance.
+        /// </summary>
+        public RaplEnergySource()
+            : this(POWERCAP_PATH)
+        {
+
+        }
+
+        /// <summary>
+        /// Initializes a new instance reading the powercap interface at the given path.
+        /// </summary>
+        /// <param name="path"></param>
+        public RaplEnergySource(string path)
+        {
+            domains = FindDomains(path);
+        }
+
+        /// <summary>
+        /// Finds the package domains which can be read. Subdomains (core, uncore, dram) are part of their package, and
+        /// the platform domain covers the packages, so either would count energy twice.
+        /// </summary>
+        /// <param name="path"></param>
+        /// <returns></returns>
+        static List<Domain> FindDomains(string path)
+        {
+            var domains = new List<Domain>();
+            if (!Directory.Exists(path))
+                return domains;
+
+            foreach (var dir in Directory.GetDirectories(path, "intel-rapl:*"))
+            {
+                if (Path.GetFileName(dir).Count(i => i == ':') != 1)
+                    continue;
+
+                try
+                {
+                    if (!File.ReadAllText(Path.Combine(dir, "name")).Trim().StartsWith("package"))
+                        continue;
+
+                    domains.Add(new Domain()
+                    {
+                        Path = Path.Combine(dir, "energy_uj"),
+                        MaxRange = Read(Path.Combine(dir, "max_energy_range_uj")),
+                        Last = Read(Path.Combine(dir, "energy_uj")),
+                    });
+                }
+                catch (IOException)
+                {
+                    // ignore
+                }
+                catch (UnauthorizedAccessException)
+                {
+                    // counters are only readable by root on most kernels
+                }
+            }
+
+            return domains;
+        }
+
+        /// <summary>
+        /// Reads a counter in micro-joules.
+        /// </summary>
+        /// <param name="path"></param>
+        /// <returns></returns>
+        static long Read(string path)
+        {
+            return long.Parse(File.ReadAllText(path).Trim(), CultureInfo.InvariantCulture);
+        }
+
+        /// <summary>
+        /// Gets whether any package could be read.
+        /// </summary>
+        public bool IsAvailable
+        {
+            get { return domains.Count > 0; }
+        }
+
+        /// <summary>
+        /// Gets the energy consumed by all packages. The counters wrap around, so they must be read at least once
+        /// within their range, which takes tens of minutes even at full load.
+        /// </summary>
+        public double Joules
+        {
+            get
+            {
+                lock (syncRoot)
+                {
+                    foreach (var domain in domains)
+                    {
+                        try
+                        {
+                            var value = Read(domain.Path);
+                            var delta = value - domain.Last;
+                            if (delta < 0)
+                                delta += domain.MaxRange;
+
+                            domain.Last = value;
+                            joules += delta / 1000000.0;
+                        }
+                        catch (IOException)
+                        {
+                            // skip the reading, the next one covers the gap
+                        }
+                    }
+
+                    return joules;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Energy counter of a single package.
+        /// </summary>
+        class Domain
+        {
+
+            public string Path;
+
+            public long MaxRange;
+
+            public long Last;
+
+        }
+
+    }
+
+}
@@ -0,0 +1,80 @@
+﻿using System.Diagnostics;
+
+namespace BitMaker.Miner
+{
+
+    /// <summary>
+    /// Energy source which consumes a set power, for testing without energy counters.
+    /// </summary>
+    public class StubEnergySource : IEnergySource
+    {
+
+        readonly object syncRoot = new object();
+
+        readonly Stopwatch stopwatch = Stopwatch.StartNew();
+
+        double watts;
+        double joules;
+        double time;
+
+        /// <summary>
+        /// Initializes a new instance.
+        /// </summary>
+        /// <param name="watts"></param>
+        public StubEnergySource(double watts)
+        {
+            this.watts = watts;
+        }
+
+        /// <summary>
+        /// Gets or sets the power being consumed. Energy consumed before the change is kept.
+        /// </summary>
+        public double Watts
+        {
+            get { return watts; }
+            set
+            {
+                lock (syncRoot)
+                {
+                    Update();
+                    watts = value;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Always available.
+        /// </summary>
+        public bool IsAvailable
+        {
+            get { return true; }
+        }
+
+        /// <summary>
+        /// Gets the energy consumed since the instance was created.
+        /// </summary>
+        public double Joules
+        {
+            get
+            {
+                lock (syncRoot)
+                {
+                    Update();
+                    return joules;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Accumulates the energy consumed since the last update.
+        /// </summary>
+        void Update()
+        {
+            var now = stopwatch.Elapsed.TotalSeconds;
+            joules += watts * (now - time);
+            time = now;
+        }
+
+    }
+
+}
@@ -1,4 +1,6 @@
-﻿using BitMaker.Utils;
+﻿using System;
+using System.Runtime.InteropServices;
+using BitMaker.Utils;
 
 namespace BitMaker.Miner
 {
@@ -10,6 +12,35 @@ namespace BitMaker.Miner
     public sealed class Work
     {
 
+        /// <summary>
+        /// Number of nonces in the complete range of a header.
+        /// </summary>
+        public const long NONCE_SPACE = 0x100000000L;
+
+        /// <summary>
+        /// Generation counter of work without a pool, which never changes.
+        /// </summary>
+        static readonly IntPtr constantGeneration = AllocateConstantGeneration();
+
+        /// <summary>
+        /// Allocates the generation counter of work without a pool.
+        /// </summary>
+        /// <returns></returns>
+        static IntPtr AllocateConstantGeneration()
+        {
+            var ptr = Marshal.AllocHGlobal(sizeof(int));
+            Marshal.WriteInt32(ptr, 0);
+            return ptr;
+        }
+
+        /// <summary>
+        /// Initializes a new instance.
+        /// </summary>
+        public Work()
+        {
+            NonceCount = NONCE_SPACE;
+        }
+
         /// <summary>
         /// Reference to the <see cref="T:Pool"/> that delivered this work.
         /// </summary>
@@ -20,6 +51,28 @@ namespace BitMaker.Miner
         /// </summary>
         public uint BlockNumber { get; set; }
 
+        /// <summary>
+        /// Generation of the <see cref="T:Pool"/> when this work was delivered.
+        /// </summary>
+        public int Generation { get; set; }
+
+        /// <summary>
+        /// Gets whether the pool has moved on to a new block since this work was delivered.
+        /// </summary>
+        public bool IsStale
+        {
+            get { return Pool != null && Pool.Generation != Generation; }
+        }
+
+        /// <summary>
+        /// Gets the address of the generation counter to compare <see cref="P:Generation"/> against, for native search
+        /// loops.
+        /// </summary>
+        public IntPtr GenerationPtr
+        {
+            get { return Pool != null ? Pool.GenerationPtr : constantGeneration; }
+        }
+
         /// <summary>
         /// Gets or sets the header data.
         /// </summary>
@@ -30,6 +83,44 @@ namespace BitMaker.Miner
         /// </summary>
         public byte[] Target { get; set; }
 
+        /// <summary>
+        /// Gets or sets the first nonce of the range to be searched.
+        /// </summary>
+        public uint NonceStart { get; set; }
+
+        /// <summary>
+        /// Gets or sets the number of nonces to be searched, beginning at <see cref="P:NonceStart"/>. Defaults to the
+        /// complete range.
+        /// </summary>
+        public long NonceCount { get; set; }
+
+        /// <summary>
+        /// Creates a copy of this work restricted to <paramref name="count"/> nonces beginning at
+        /// <paramref name="start"/>, which must lie within the nonces of this work. The copy has its own header, so it
+        /// may be solved independently.
+        /// </summary>
+        /// <param name="start"></param>
+        /// <param name="count"></param>
+        /// <returns></returns>
+        public Work Split(uint start, long count)
+        {
+            if (count <= 0 || count > NONCE_SPACE)
+                throw new ArgumentOutOfRangeException("count");
+            if (start < NonceStart || start + count > NonceStart + NonceCount)
+                throw new ArgumentOutOfRangeException("start");
+
+            return new Work()
+            {
+                Pool = Pool,
+                BlockNumber = BlockNumber,
+                Generation = Generation,
+                Header = (byte[])Header.Clone(),
+                Target = Target,
+                NonceStart = start,
+                NonceCount = count,
+            };
+        }
+
         /// <summary>
         /// Ensures the current header generates a hash that matches the target difficulty.
         /// </summary>
@@ -0,0 +1,428 @@
+﻿using System;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Threading;
+
+using BitMaker.Utils;
+
+namespace BitMaker.Miner
+{
+
+    /// <summary>
+    /// Block of native memory holding the <see cref="WorkDescriptor"/>s of a single miner thread, each aligned to a
+    /// cache line. Descriptors are reused for every work item the thread processes, so the hashing path does not
+    /// allocate from the managed heap. An arena is owned by the thread which created it and is not thread-safe.
+    /// </summary>
+    public sealed unsafe class WorkArena : IDisposable
+    {
+
+        /// <summary>
+        /// Alignment of each descriptor, the size of a cache line.
+        /// </summary>
+        public const int ALIGNMENT = 64;
+
+        const uint MEM_COMMIT = 0x1000;
+        const uint MEM_RESERVE = 0x2000;
+        const uint MEM_RELEASE = 0x8000;
+        const uint MEM_LARGE_PAGES = 0x20000000;
+        const uint PAGE_READWRITE = 0x04;
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        static extern IntPtr VirtualAlloc(IntPtr address, UIntPtr size, uint allocationType, uint protect);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        static extern bool VirtualFree(IntPtr address, UIntPtr size, uint freeType);
+
+        [DllImport("kernel32.dll")]
+        static extern UIntPtr GetLargePageMinimum();
+
+        [DllImport("kernel32.dll")]
+        static extern IntPtr GetCurrentProcess();
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        static extern bool K32QueryWorkingSetEx(IntPtr process, ref PSAPI_WORKING_SET_EX_INFORMATION info, int size);
+
+        [StructLayout(LayoutKind.Sequential)]
+        struct PSAPI_WORKING_SET_EX_INFORMATION
+        {
+            public IntPtr VirtualAddress;
+            public UIntPtr VirtualAttributes;
+        }
+
+        const int PROT_NONE = 0x0;
+        const int PROT_READ = 0x1;
+        const int PROT_WRITE = 0x2;
+        const int MAP_PRIVATE = 0x02;
+        const int MAP_ANONYMOUS = 0x20;
+        const int MADV_HUGEPAGE = 14;
+        static readonly IntPtr MAP_FAILED = new IntPtr(-1);
+
+        [DllImport("libc", SetLastError = true)]
+        static extern IntPtr mmap(IntPtr address, UIntPtr length, int prot, int flags, int fd, IntPtr offset);
+
+        [DllImport("libc", SetLastError = true)]
+        static extern int munmap(IntPtr address, UIntPtr length);
+
+        [DllImport("libc", SetLastError = true)]
+        static extern int mprotect(IntPtr address, UIntPtr length, int prot);
+
+        [DllImport("libc", SetLastError = true)]
+        static extern int madvise(IntPtr address, UIntPtr length, int advice);
+
+        /// <summary>
+        /// Size of a transparent huge page, if not reported by the system.
+        /// </summary>
+        const long HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+        /// <summary>
+        /// Gets whether we are running on a Unix-like system.
+        /// </summary>
+        static bool IsUnix
+        {
+            get { return Environment.OSVersion.Platform == PlatformID.Unix || Environment.OSVersion.Platform == PlatformID.MacOSX; }
+        }
+
+        /// <summary>
+        /// Gets whether we are running on Linux, where the arena is mapped on its own so that the placement of its
+        /// pages can be read back from /proc.
+        /// </summary>
+        static bool IsLinux
+        {
+            get { return IsUnix && File.Exists("/proc/self/numa_maps"); }
+        }
+
+        /// <summary>
+        /// Distance between descriptors, their size rounded up to the alignment.
+        /// </summary>
+        static readonly int stride = (sizeof(WorkDescriptor) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+        /// <summary>
+        /// Set once it has been reported that large pages could not be had.
+        /// </summary>
+        static int largePagesReported;
+
+        /// <summary>
+        /// Memory as allocated, and the first aligned descriptor within it.
+        /// </summary>
+        IntPtr memory;
+        byte* descriptors;
+
+        /// <summary>
+        /// Size of the memory if it was mapped, rather than allocated from the process heap.
+        /// </summary>
+        long mappedSize;
+
+        /// <summary>
+        /// Gets the number of descriptors in the arena.
+        /// </summary>
+        public int Count { get; private set; }
+
+        /// <summary>
+        /// Gets whether the arena is backed by large pages.
+        /// </summary>
+        public bool IsLargePages { get; private set; }
+
+        /// <summary>
+        /// Gets the NUMA node the memory of the arena was placed on, as reported by the system once it is first
+        /// touched, or -1 if the system does not report it.
+        /// </summary>
+        public int Node { get; private set; }
+
+        /// <summary>
+        /// Initializes a new instance holding <paramref name="count"/> descriptors. If <paramref name="largePages"/>
+        /// is set the arena is backed by large pages where the system allows it: on Windows this requires the lock
+        /// pages in memory privilege, on Linux transparent huge pages enabled for madvise or always. Otherwise, or if
+        /// they cannot be had, it uses normal pages, which is reported once.
+        /// </summary>
+        /// <param name="count"></param>
+        /// <param name="largePages"></param>
+        public WorkArena(int count, bool largePages)
+        {
+            if (count <= 0)
+                throw new ArgumentOutOfRangeException("count");
+
+            Count = count;
+
+            if (largePages && !IsUnix)
+                AllocateLargePages();
+
+            if (memory == IntPtr.Zero && IsLinux)
+                AllocateMapped(largePages);
+
+            if (memory == IntPtr.Zero)
+            {
+                // over allocate so the first descriptor can be moved up to the alignment
+                memory = Marshal.AllocHGlobal(stride * count + ALIGNMENT - 1);
+                descriptors = (byte*)(((long)memory + ALIGNMENT - 1) & ~(long)(ALIGNMENT - 1));
+            }
+
+            // first touch, which places the pages on the node of the calling thread
+            Memory.Zero(descriptors, stride * count);
+            Node = IsUnix ? GetMappedNode() : GetWorkingSetNode();
+
+            if (IsUnix && largePages)
+                IsLargePages = GetMappedHugePages() > 0;
+
+            if (largePages && !IsLargePages && Interlocked.Exchange(ref largePagesReported, 1) == 0)
+                Console.WriteLine("MEMORY  : large pages unavailable, work buffers use normal pages");
+        }
+
+        /// <summary>
+        /// Initializes a new instance holding <paramref name="count"/> descriptors, backed by large pages if so
+        /// configured.
+        /// </summary>
+        /// <param name="count"></param>
+        public WorkArena(int count)
+            : this(count, ConfigurationSection.GetDefaultSection().LargePages)
+        {
+
+        }
+
+        /// <summary>
+        /// Attempts to allocate the arena from large pages, which are already aligned.
+        /// </summary>
+        void AllocateLargePages()
+        {
+            try
+            {
+                var page = (long)GetLargePageMinimum();
+                if (page == 0)
+                    return;
+
+                var size = (stride * Count + page - 1) / page * page;
+                memory = VirtualAlloc(IntPtr.Zero, new UIntPtr((ulong)size), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+                descriptors = (byte*)memory;
+                IsLargePages = memory != IntPtr.Zero;
+            }
+            catch (EntryPointNotFoundException)
+            {
+                // not supported by the system
+            }
+            catch (DllNotFoundException)
+            {
+                // not supported by the system
+            }
+        }
+
+        /// <summary>
+        /// Attempts to map the arena as its own anonymous region, aligned to a page, or to a transparent huge page
+        /// which it is advised to use if <paramref name="largePages"/> is set. A guard page on either side keeps the
+        /// system from merging the region with its neighbours, so that it can be found in /proc by its address.
+        /// </summary>
+        /// <param name="largePages"></param>
+        void AllocateMapped(bool largePages)
+        {
+            try
+            {
+                var page = (long)Environment.SystemPageSize;
+                var align = largePages ? GetHugePageSize() : page;
+                var size = (stride * Count + align - 1) / align * align;
+
+                // room to move the region up to the alignment, past the leading guard page
+                var length = size + align + page;
+                var address = mmap(IntPtr.Zero, new UIntPtr((ulong)length), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, IntPtr.Zero);
+                if (address == MAP_FAILED)
+                    return;
+
+                var start = ((long)address + page + align - 1) / align * align;
+                mprotect(new IntPtr(start - page), new UIntPtr((ulong)page), PROT_NONE);
+                mprotect(new IntPtr(start + size), new UIntPtr((ulong)page), PROT_NONE);
+
+                // only a hint, which the system may not follow
+                if (largePages)
+                    madvise(new IntPtr(start), new UIntPtr((ulong)size), MADV_HUGEPAGE);
+
+                memory = address;
+                descriptors = (byte*)start;
+                mappedSize = length;
+            }
+            catch (EntryPointNotFoundException)
+            {
+                // not supported by the system
+            }
+            catch (DllNotFoundException)
+            {
+                // not supported by the system
+            }
+        }
+
+        /// <summary>
+        /// Gets the size of a transparent huge page.
+        /// </summary>
+        /// <returns></returns>
+        static long GetHugePageSize()
+        {
+            try
+            {
+                return long.Parse(File.ReadAllText("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size").Trim(), CultureInfo.InvariantCulture);
+            }
+            catch (Exception)
+            {
+                return HUGE_PAGE_SIZE;
+            }
+        }
+
+        /// <summary>
+        /// Gets the number of kilobytes of the mapped arena backed by transparent huge pages, from its entry in
+        /// /proc/self/smaps, which begins with its address range and holds a line like "AnonHugePages: 2048 kB".
+        /// </summary>
+        /// <returns></returns>
+        long GetMappedHugePages()
+        {
+            if (mappedSize == 0)
+                return 0;
+
+            try
+            {
+                var start = ((long)descriptors).ToString("x") + "-";
+                var found = false;
+                foreach (var line in File.ReadLines("/proc/self/smaps"))
+                {
+                    // entries begin with the address range, fields follow
+                    if (char.IsDigit(line[0]) || (line[0] >= 'a' && line[0] <= 'f'))
+                    {
+                        if (found)
+                            break;
+
+                        found = line.StartsWith(start);
+                    }
+                    else if (found && line.StartsWith("AnonHugePages:"))
+                        return long.Parse(line.Substring(14).Trim().Split(' ')[0], CultureInfo.InvariantCulture);
+                }
+            }
+            catch (IOException)
+            {
+                // not reported
+            }
+            catch (UnauthorizedAccessException)
+            {
+                // not reported
+            }
+
+            return 0;
+        }
+
+        /// <summary>
+        /// Gets the node holding most pages of the mapped arena, from its entry in /proc/self/numa_maps, which reads
+        /// like "7f0e5c000000 default anon=1 dirty=1 N0=1 kernelpagesize_kB=4".
+        /// </summary>
+        /// <returns></returns>
+        int GetMappedNode()
+        {
+            if (mappedSize == 0)
+                return -1;
+
+            try
+            {
+                var start = ((long)descriptors).ToString("x");
+                var fields = File.ReadLines("/proc/self/numa_maps")
+                    .Select(i => i.Split(' '))
+                    .FirstOrDefault(i => i[0] == start);
+                if (fields == null)
+                    return -1;
+
+                // page counts by node, as N<node>=<pages>
+                var node = fields
+                    .Where(i => i.Length > 1 && i[0] == 'N' && char.IsDigit(i[1]) && i.IndexOf('=') > 0)
+                    .Select(i => i.Substring(1).Split('='))
+                    .Select(i => new { Node = int.Parse(i[0], CultureInfo.InvariantCulture), Pages = long.Parse(i[1], CultureInfo.InvariantCulture) })
+                    .OrderByDescending(i => i.Pages)
+                    .FirstOrDefault();
+
+                return node != null ? node.Node : -1;
+            }
+            catch (IOException)
+            {
+                return -1;
+            }
+            catch (UnauthorizedAccessException)
+            {
+                return -1;
+            }
+        }
+
+        /// <summary>
+        /// Gets the node of the first page of the arena from the working set of the process, which holds it in bits
+        /// 16 to 21 of the attributes of a valid page.
+        /// </summary>
+        /// <returns></returns>
+        int GetWorkingSetNode()
+        {
+            try
+            {
+                var info = new PSAPI_WORKING_SET_EX_INFORMATION() { VirtualAddress = (IntPtr)descriptors };
+                if (!K32QueryWorkingSetEx(GetCurrentProcess(), ref info, Marshal.SizeOf(info)))
+                    return -1;
+
+                var attributes = (ulong)info.VirtualAttributes;
+                if ((attributes & 1) == 0)
+                    return -1;
+
+                return (int)((attributes >> 16) & 0x3f);
+            }
+            catch (EntryPointNotFoundException)
+            {
+                return -1;
+            }
+            catch (DllNotFoundException)
+            {
+                return -1;
+            }
+        }
+
+        /// <summary>
+        /// Gets the descriptor at <paramref name="index"/>.
+        /// </summary>
+        /// <param name="index"></param>
+        /// <returns></returns>
+        public WorkDescriptor* this[int index]
+        {
+            get
+            {
+                if (descriptors == null)
+                    throw new ObjectDisposedException(GetType().Name);
+                if (index < 0 || index >= Count)
+                    throw new ArgumentOutOfRangeException("index");
+
+                return (WorkDescriptor*)(descriptors + stride * index);
+            }
+        }
+
+        /// <summary>
+        /// Releases the memory of the arena.
+        /// </summary>
+        public void Dispose()
+        {
+            Free();
+            GC.SuppressFinalize(this);
+        }
+
+        /// <summary>
+        /// Releases the memory of the arena if it was not disposed.
+        /// </summary>
+        ~WorkArena()
+        {
+            Free();
+        }
+
+        void Free()
+        {
+            if (memory == IntPtr.Zero)
+                return;
+
+            if (mappedSize > 0)
+                munmap(memory, new UIntPtr((ulong)mappedSize));
+            else if (IsLargePages)
+                VirtualFree(memory, UIntPtr.Zero, MEM_RELEASE);
+            else
+                Marshal.FreeHGlobal(memory);
+
+            memory = IntPtr.Zero;
+            descriptors = null;
+        }
+
+    }
+
+}
@@ -0,0 +1,52 @@
+﻿using System.Runtime.InteropServices;
+
+namespace BitMaker.Miner
+{
+
+    /// <summary>
+    /// Native buffers used to process a work item: the prepared blocks and states handed to the search functions, and
+    /// the scratch space of the precalculation. Descriptors live in a <see cref="WorkArena"/> and are recycled from one
+    /// work item to the next.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct WorkDescriptor
+    {
+
+        /// <summary>
+        /// Largest number of work items searched together, the widest vector lane count.
+        /// </summary>
+        public const int MAX_PACKED_WORK = 8;
+
+        /// <summary>
+        /// Both blocks of the header, in host order with the SHA-256 padding applied.
+        /// </summary>
+        public fixed byte Round1Blocks[128];
+
+        /// <summary>
+        /// State after the first block of the header.
+        /// </summary>
+        public fixed uint Round1State[8];
+
+        /// <summary>
+        /// Round 1 states of work items searched together, one after another.
+        /// </summary>
+        public fixed uint Round1States[MAX_PACKED_WORK * 8];
+
+        /// <summary>
+        /// Round 1 second blocks of work items searched together, one after another.
+        /// </summary>
+        public fixed byte Round1Blocks2[MAX_PACKED_WORK * 64];
+
+        /// <summary>
+        /// State after the nonce independent rounds of the second block of the header.
+        /// </summary>
+        public fixed uint Midstate[8];
+
+        /// <summary>
+        /// Message schedule scratch space.
+        /// </summary>
+        public fixed uint Schedule[64];
+
+    }
+
+}
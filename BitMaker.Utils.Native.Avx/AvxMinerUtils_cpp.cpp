@@ -25,12 +25,21 @@
 
 #define add2(a, b) (_mm256_add_epi32(a, b))
 
+#define add3(a, b, c) (add2(add2(a, b), c))
+
 #define add4(a, b, c, d) (add2(add2(a, b), add2(c, d)))
 
 #define add5(a, b, c, d, e) add2(add4(a, b, c, d), e)
 
 #define mm256_extract_epi16(a, b) (_mm_extract_epi16 (_mm256_extractf128_si256 (a, b >> 3), b % 8))
 
+// selects the message schedule layout of the specialized transforms: 1 computes it in a 16 entry circular window
+// interleaved with the rounds, 0 materializes all of it ahead of the rounds; with only sixteen YMM registers neither stays
+// resident, and the window measured slower as the compiler spills more of it across the rounds
+#ifndef SHA256_ROLLING_SCHEDULE
+#define SHA256_ROLLING_SCHEDULE 0
+#endif
+
 static inline void sha256_transform(__m256i *state, __m256i *block, __m256i *dst)
 {
     __m256i W[64], t1, t2;
@@ -101,48 +110,706 @@ static inline void sha256_transform(__m256i *state, __m256i *block, __m256i *dst
     W[62] = add4(sigma1(W[62 - 2]), W[62 - 7], sigma0(W[62 - 15]), W[62 - 16]);
     W[63] = add4(sigma1(W[63 - 2]), W[63 - 7], sigma0(W[63 - 15]), W[63 - 16]);
 
-    // read existing state
-    __m256i a = state[0];
-    __m256i b = state[1];
-    __m256i c = state[2];
-    __m256i d = state[3];
-    __m256i e = state[4];
-    __m256i f = state[5];
-    __m256i g = state[6];
-    __m256i h = state[7];
-    
-    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x428a2f98), W[0]);
-    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
-    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x71374491), W[1]);
-    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
-    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0xb5c0fbcf), W[2]);
-    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
-    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0xe9b5dba5), W[3]);
-    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
-    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x3956c25b), W[4]);
+    // read existing state
+    __m256i a = state[0];
+    __m256i b = state[1];
+    __m256i c = state[2];
+    __m256i d = state[3];
+    __m256i e = state[4];
+    __m256i f = state[5];
+    __m256i g = state[6];
+    __m256i h = state[7];
+    
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x428a2f98), W[0]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x71374491), W[1]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0xb5c0fbcf), W[2]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0xe9b5dba5), W[3]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x3956c25b), W[4]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x59f111f1), W[5]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x923f82a4), W[6]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xab1c5ed5), W[7]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0xd807aa98), W[8]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x12835b01), W[9]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x243185be), W[10]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x550c7dc3), W[11]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x72be5d74), W[12]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x80deb1fe), W[13]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x9bdc06a7), W[14]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xc19bf174), W[15]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0xe49b69c1), W[16]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0xefbe4786), W[17]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x0fc19dc6), W[18]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x240ca1cc), W[19]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x2de92c6f), W[20]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x4a7484aa), W[21]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x5cb0a9dc), W[22]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x76f988da), W[23]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x983e5152), W[24]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0xa831c66d), W[25]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0xb00327c8), W[26]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0xbf597fc7), W[27]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0xc6e00bf3), W[28]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0xd5a79147), W[29]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x06ca6351), W[30]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x14292967), W[31]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x27b70a85), W[32]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x2e1b2138), W[33]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x4d2c6dfc), W[34]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x53380d13), W[35]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x650a7354), W[36]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x766a0abb), W[37]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x81c2c92e), W[38]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x92722c85), W[39]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0xa2bfe8a1), W[40]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0xa81a664b), W[41]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0xc24b8b70), W[42]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0xc76c51a3), W[43]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0xd192e819), W[44]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0xd6990624), W[45]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0xf40e3585), W[46]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x106aa070), W[47]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x19a4c116), W[48]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x1e376c08), W[49]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x2748774c), W[50]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x34b0bcb5), W[51]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x391c0cb3), W[52]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x4ed8aa4a), W[53]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x5b9cca4f), W[54]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x682e6ff3), W[55]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x748f82ee), W[56]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x78a5636f), W[57]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x84c87814), W[58]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x8cc70208), W[59]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x90befffa), W[60]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0xa4506ceb), W[61]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0xbef9a3f7), W[62]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xc67178f2), W[63]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+    
+    dst[0] = add2(state[0], a);
+    dst[1] = add2(state[1], b);
+    dst[2] = add2(state[2], c);
+    dst[3] = add2(state[3], d);
+    dst[4] = add2(state[4], e);
+    dst[5] = add2(state[5], f);
+    dst[6] = add2(state[6], g);
+    dst[7] = add2(state[7], h);
+}
+
+// calculates the portion of the round 1 block 2 transform which does not depend on the nonce, W[3]: the state after
+// the first three rounds with the nonce independent half of the fourth applied, and partial message schedule entries
+static inline void sha256_precalc(__m256i *state, __m256i *block, __m256i *mid, __m256i *W)
+{
+    __m256i t1, t2;
+
+    // read existing state
+    __m256i a = state[0];
+    __m256i b = state[1];
+    __m256i c = state[2];
+    __m256i d = state[3];
+    __m256i e = state[4];
+    __m256i f = state[5];
+    __m256i g = state[6];
+    __m256i h = state[7];
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x428a2f98), block[0]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x71374491), block[1]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0xb5c0fbcf), block[2]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+
+    // fourth round, less the nonce
+    t1 = add4(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0xe9b5dba5));
+    t2 = add2(Sigma0(f), Maj(f, g, h));
+
+    mid[0] = add2(a, t1);
+    mid[1] = b;
+    mid[2] = c;
+    mid[3] = d;
+    mid[4] = add2(t1, t2);
+    mid[5] = f;
+    mid[6] = g;
+    mid[7] = h;
+
+    // W[16], W[17] and the nonce independent terms of W[18], W[19], W[31] and W[32]
+    W[0] = add2(sigma0(block[1]), block[0]);
+    W[1] = add3(_mm256_set1_epi32(0x01100000), sigma0(block[2]), block[1]);
+    W[2] = add2(sigma1(W[0]), block[2]);
+    W[3] = add2(sigma1(W[1]), _mm256_set1_epi32(0x11002000));
+    W[4] = add2(sigma0(W[0]), _mm256_set1_epi32(0x00000280));
+    W[5] = add2(sigma0(W[1]), W[0]);
+}
+
+#if SHA256_ROLLING_SCHEDULE
+
+// transforms round 1 block 2 for the given nonce vector, starting from the values calculated by sha256_precalc; the
+// remainder of the block is the fixed SHA-256 padding of an 80 byte header, and the
+// message schedule is computed in a 16 entry circular window as the rounds consume it
+static inline void sha256_transform_nonce(__m256i *state, __m256i *mid, __m256i *pre, __m256i nonce, __m256i *dst)
+{
+    __m256i W[16], t1, t2;
+
+    // complete the fourth round with the nonce
+    __m256i a = add2(mid[0], nonce);
+    __m256i b = mid[1];
+    __m256i c = mid[2];
+    __m256i d = mid[3];
+    __m256i e = add2(mid[4], nonce);
+    __m256i f = mid[5];
+    __m256i g = mid[6];
+    __m256i h = mid[7];
+
+    t1 = add4(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0xb956c25b));
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add4(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x59f111f1));
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add4(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x923f82a4));
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add4(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xab1c5ed5));
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add4(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0xd807aa98));
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add4(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x12835b01));
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add4(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x243185be));
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add4(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x550c7dc3));
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add4(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x72be5d74));
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add4(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x80deb1fe));
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add4(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x9bdc06a7));
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add4(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xc19bf3f4));
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    W[0] = pre[0];
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0xe49b69c1), W[0]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    W[1] = pre[1];
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0xefbe4786), W[1]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    W[2] = add2(pre[2], sigma0(nonce));
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x0fc19dc6), W[2]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    W[3] = add2(pre[3], nonce);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x240ca1cc), W[3]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    W[4] = add2(sigma1(W[2]), _mm256_set1_epi32(0x80000000));
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x2de92c6f), W[4]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    W[5] = sigma1(W[3]);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x4a7484aa), W[5]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    W[6] = add2(sigma1(W[4]), _mm256_set1_epi32(0x00000280));
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x5cb0a9dc), W[6]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    W[7] = add2(sigma1(W[5]), W[0]);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x76f988da), W[7]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    W[8] = add2(sigma1(W[6]), W[1]);
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x983e5152), W[8]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    W[9] = add2(sigma1(W[7]), W[2]);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0xa831c66d), W[9]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    W[10] = add2(sigma1(W[8]), W[3]);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0xb00327c8), W[10]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    W[11] = add2(sigma1(W[9]), W[4]);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0xbf597fc7), W[11]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    W[12] = add2(sigma1(W[10]), W[5]);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0xc6e00bf3), W[12]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    W[13] = add2(sigma1(W[11]), W[6]);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0xd5a79147), W[13]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    W[14] = add3(sigma1(W[12]), W[7], _mm256_set1_epi32(0x00a00055));
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x06ca6351), W[14]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    W[15] = add3(sigma1(W[13]), W[8], pre[4]);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x14292967), W[15]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    W[0] = add3(sigma1(W[14]), W[9], pre[5]);
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x27b70a85), W[0]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    W[1] = add4(sigma1(W[15]), W[10], sigma0(W[2]), W[1]);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x2e1b2138), W[1]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    W[2] = add4(sigma1(W[0]), W[11], sigma0(W[3]), W[2]);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x4d2c6dfc), W[2]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    W[3] = add4(sigma1(W[1]), W[12], sigma0(W[4]), W[3]);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x53380d13), W[3]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    W[4] = add4(sigma1(W[2]), W[13], sigma0(W[5]), W[4]);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x650a7354), W[4]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    W[5] = add4(sigma1(W[3]), W[14], sigma0(W[6]), W[5]);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x766a0abb), W[5]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    W[6] = add4(sigma1(W[4]), W[15], sigma0(W[7]), W[6]);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x81c2c92e), W[6]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    W[7] = add4(sigma1(W[5]), W[0], sigma0(W[8]), W[7]);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x92722c85), W[7]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    W[8] = add4(sigma1(W[6]), W[1], sigma0(W[9]), W[8]);
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0xa2bfe8a1), W[8]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    W[9] = add4(sigma1(W[7]), W[2], sigma0(W[10]), W[9]);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0xa81a664b), W[9]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    W[10] = add4(sigma1(W[8]), W[3], sigma0(W[11]), W[10]);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0xc24b8b70), W[10]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    W[11] = add4(sigma1(W[9]), W[4], sigma0(W[12]), W[11]);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0xc76c51a3), W[11]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    W[12] = add4(sigma1(W[10]), W[5], sigma0(W[13]), W[12]);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0xd192e819), W[12]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    W[13] = add4(sigma1(W[11]), W[6], sigma0(W[14]), W[13]);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0xd6990624), W[13]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    W[14] = add4(sigma1(W[12]), W[7], sigma0(W[15]), W[14]);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0xf40e3585), W[14]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    W[15] = add4(sigma1(W[13]), W[8], sigma0(W[0]), W[15]);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x106aa070), W[15]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    W[0] = add4(sigma1(W[14]), W[9], sigma0(W[1]), W[0]);
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x19a4c116), W[0]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    W[1] = add4(sigma1(W[15]), W[10], sigma0(W[2]), W[1]);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x1e376c08), W[1]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    W[2] = add4(sigma1(W[0]), W[11], sigma0(W[3]), W[2]);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x2748774c), W[2]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    W[3] = add4(sigma1(W[1]), W[12], sigma0(W[4]), W[3]);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x34b0bcb5), W[3]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    W[4] = add4(sigma1(W[2]), W[13], sigma0(W[5]), W[4]);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x391c0cb3), W[4]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    W[5] = add4(sigma1(W[3]), W[14], sigma0(W[6]), W[5]);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x4ed8aa4a), W[5]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    W[6] = add4(sigma1(W[4]), W[15], sigma0(W[7]), W[6]);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x5b9cca4f), W[6]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    W[7] = add4(sigma1(W[5]), W[0], sigma0(W[8]), W[7]);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x682e6ff3), W[7]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    W[8] = add4(sigma1(W[6]), W[1], sigma0(W[9]), W[8]);
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x748f82ee), W[8]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    W[9] = add4(sigma1(W[7]), W[2], sigma0(W[10]), W[9]);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x78a5636f), W[9]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    W[10] = add4(sigma1(W[8]), W[3], sigma0(W[11]), W[10]);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x84c87814), W[10]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    W[11] = add4(sigma1(W[9]), W[4], sigma0(W[12]), W[11]);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x8cc70208), W[11]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    W[12] = add4(sigma1(W[10]), W[5], sigma0(W[13]), W[12]);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x90befffa), W[12]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    W[13] = add4(sigma1(W[11]), W[6], sigma0(W[14]), W[13]);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0xa4506ceb), W[13]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    W[14] = add4(sigma1(W[12]), W[7], sigma0(W[15]), W[14]);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0xbef9a3f7), W[14]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    W[15] = add4(sigma1(W[13]), W[8], sigma0(W[0]), W[15]);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xc67178f2), W[15]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    dst[0] = add2(state[0], a);
+    dst[1] = add2(state[1], b);
+    dst[2] = add2(state[2], c);
+    dst[3] = add2(state[3], d);
+    dst[4] = add2(state[4], e);
+    dst[5] = add2(state[5], f);
+    dst[6] = add2(state[6], g);
+    dst[7] = add2(state[7], h);
+}
+
+// transforms the round 2 block from the initial SHA-256 state, returning only the last word of the state less its
+// initial value; the remainder of the block is the fixed SHA-256 padding of a 32 byte hash, and the
+// message schedule is computed in a 16 entry circular window as the rounds consume it
+static inline __m256i sha256_transform_final(__m256i *block)
+{
+    __m256i W[16], t1, t2;
+
+    W[0]  = block[0];
+    W[1]  = block[1];
+    W[2]  = block[2];
+    W[3]  = block[3];
+    W[4]  = block[4];
+    W[5]  = block[5];
+    W[6]  = block[6];
+    W[7]  = block[7];
+
+    // initial state, with the first round applied
+    __m256i a = _mm256_set1_epi32(0x6a09e667);
+    __m256i b = _mm256_set1_epi32(0xbb67ae85);
+    __m256i c = _mm256_set1_epi32(0x3c6ef372);
+    __m256i d = add2(_mm256_set1_epi32(0x98c7e2a2), W[0]);
+    __m256i e = _mm256_set1_epi32(0x510e527f);
+    __m256i f = _mm256_set1_epi32(0x9b05688c);
+    __m256i g = _mm256_set1_epi32(0x1f83d9ab);
+    __m256i h = add2(_mm256_set1_epi32(0xfc08884d), W[0]);
+
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x71374491), W[1]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0xb5c0fbcf), W[2]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0xe9b5dba5), W[3]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x3956c25b), W[4]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x59f111f1), W[5]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x923f82a4), W[6]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xab1c5ed5), W[7]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add4(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x5807aa98));
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add4(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x12835b01));
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add4(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x243185be));
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add4(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x550c7dc3));
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add4(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x72be5d74));
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add4(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x80deb1fe));
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add4(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x9bdc06a7));
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add4(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xc19bf274));
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    W[0] = add2(sigma0(W[1]), W[0]);
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0xe49b69c1), W[0]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    W[1] = add3(_mm256_set1_epi32(0x00a00000), sigma0(W[2]), W[1]);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0xefbe4786), W[1]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    W[2] = add3(sigma1(W[0]), sigma0(W[3]), W[2]);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x0fc19dc6), W[2]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    W[3] = add3(sigma1(W[1]), sigma0(W[4]), W[3]);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x240ca1cc), W[3]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    W[4] = add3(sigma1(W[2]), sigma0(W[5]), W[4]);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x2de92c6f), W[4]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    W[5] = add3(sigma1(W[3]), sigma0(W[6]), W[5]);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x4a7484aa), W[5]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    W[6] = add4(sigma1(W[4]), _mm256_set1_epi32(0x00000100), sigma0(W[7]), W[6]);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x5cb0a9dc), W[6]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    W[7] = add4(sigma1(W[5]), W[0], _mm256_set1_epi32(0x11002000), W[7]);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x76f988da), W[7]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    W[8] = add3(sigma1(W[6]), W[1], _mm256_set1_epi32(0x80000000));
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x983e5152), W[8]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    W[9] = add2(sigma1(W[7]), W[2]);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0xa831c66d), W[9]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    W[10] = add2(sigma1(W[8]), W[3]);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0xb00327c8), W[10]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    W[11] = add2(sigma1(W[9]), W[4]);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0xbf597fc7), W[11]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    W[12] = add2(sigma1(W[10]), W[5]);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0xc6e00bf3), W[12]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    W[13] = add2(sigma1(W[11]), W[6]);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0xd5a79147), W[13]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    W[14] = add3(sigma1(W[12]), W[7], _mm256_set1_epi32(0x00400022));
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x06ca6351), W[14]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    W[15] = add4(sigma1(W[13]), W[8], sigma0(W[0]), _mm256_set1_epi32(0x00000100));
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x14292967), W[15]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    W[0] = add4(sigma1(W[14]), W[9], sigma0(W[1]), W[0]);
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x27b70a85), W[0]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    W[1] = add4(sigma1(W[15]), W[10], sigma0(W[2]), W[1]);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x2e1b2138), W[1]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    W[2] = add4(sigma1(W[0]), W[11], sigma0(W[3]), W[2]);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x4d2c6dfc), W[2]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    W[3] = add4(sigma1(W[1]), W[12], sigma0(W[4]), W[3]);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x53380d13), W[3]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    W[4] = add4(sigma1(W[2]), W[13], sigma0(W[5]), W[4]);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x650a7354), W[4]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    W[5] = add4(sigma1(W[3]), W[14], sigma0(W[6]), W[5]);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x766a0abb), W[5]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    W[6] = add4(sigma1(W[4]), W[15], sigma0(W[7]), W[6]);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x81c2c92e), W[6]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    W[7] = add4(sigma1(W[5]), W[0], sigma0(W[8]), W[7]);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x92722c85), W[7]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    W[8] = add4(sigma1(W[6]), W[1], sigma0(W[9]), W[8]);
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0xa2bfe8a1), W[8]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    W[9] = add4(sigma1(W[7]), W[2], sigma0(W[10]), W[9]);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0xa81a664b), W[9]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    W[10] = add4(sigma1(W[8]), W[3], sigma0(W[11]), W[10]);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0xc24b8b70), W[10]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    W[11] = add4(sigma1(W[9]), W[4], sigma0(W[12]), W[11]);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0xc76c51a3), W[11]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    W[12] = add4(sigma1(W[10]), W[5], sigma0(W[13]), W[12]);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0xd192e819), W[12]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    W[13] = add4(sigma1(W[11]), W[6], sigma0(W[14]), W[13]);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0xd6990624), W[13]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    W[14] = add4(sigma1(W[12]), W[7], sigma0(W[15]), W[14]);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0xf40e3585), W[14]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    W[15] = add4(sigma1(W[13]), W[8], sigma0(W[0]), W[15]);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x106aa070), W[15]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    W[0] = add4(sigma1(W[14]), W[9], sigma0(W[1]), W[0]);
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x19a4c116), W[0]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    W[1] = add4(sigma1(W[15]), W[10], sigma0(W[2]), W[1]);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x1e376c08), W[1]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    W[2] = add4(sigma1(W[0]), W[11], sigma0(W[3]), W[2]);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x2748774c), W[2]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    W[3] = add4(sigma1(W[1]), W[12], sigma0(W[4]), W[3]);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x34b0bcb5), W[3]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    W[4] = add4(sigma1(W[2]), W[13], sigma0(W[5]), W[4]);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x391c0cb3), W[4]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    W[5] = add4(sigma1(W[3]), W[14], sigma0(W[6]), W[5]);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x4ed8aa4a), W[5]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    W[6] = add4(sigma1(W[4]), W[15], sigma0(W[7]), W[6]);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x5b9cca4f), W[6]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    W[7] = add4(sigma1(W[5]), W[0], sigma0(W[8]), W[7]);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x682e6ff3), W[7]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    W[8] = add4(sigma1(W[6]), W[1], sigma0(W[9]), W[8]);
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x748f82ee), W[8]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    W[9] = add4(sigma1(W[7]), W[2], sigma0(W[10]), W[9]);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x78a5636f), W[9]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    W[10] = add4(sigma1(W[8]), W[3], sigma0(W[11]), W[10]);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x84c87814), W[10]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    W[11] = add4(sigma1(W[9]), W[4], sigma0(W[12]), W[11]);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x8cc70208), W[11]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+
+    // only the last word of the state is tested, which is final after this round
+    W[12] = add4(sigma1(W[10]), W[5], sigma0(W[13]), W[12]);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x90befffa), W[12]);
+
+    return add2(h, t1);
+}
+
+#else
+
+// transforms round 1 block 2 for the given nonce vector, starting from the values calculated by sha256_precalc; the
+// remainder of the block is the fixed SHA-256 padding of an 80 byte header
+static inline void sha256_transform_nonce(__m256i *state, __m256i *mid, __m256i *pre, __m256i nonce, __m256i *dst)
+{
+    __m256i W[64], t1, t2;
+
+    W[16] = pre[0];
+    W[17] = pre[1];
+    W[18] = add2(pre[2], sigma0(nonce));
+    W[19] = add2(pre[3], nonce);
+    W[20] = add2(sigma1(W[18]), _mm256_set1_epi32(0x80000000));
+    W[21] = sigma1(W[19]);
+    W[22] = add2(sigma1(W[20]), _mm256_set1_epi32(0x00000280));
+    W[23] = add2(sigma1(W[23 - 2]), W[23 - 7]);
+    W[24] = add2(sigma1(W[24 - 2]), W[24 - 7]);
+    W[25] = add2(sigma1(W[25 - 2]), W[25 - 7]);
+    W[26] = add2(sigma1(W[26 - 2]), W[26 - 7]);
+    W[27] = add2(sigma1(W[27 - 2]), W[27 - 7]);
+    W[28] = add2(sigma1(W[28 - 2]), W[28 - 7]);
+    W[29] = add2(sigma1(W[29 - 2]), W[29 - 7]);
+    W[30] = add3(sigma1(W[30 - 2]), W[30 - 7], _mm256_set1_epi32(0x00a00055));
+    W[31] = add3(sigma1(W[31 - 2]), W[31 - 7], pre[4]);
+    W[32] = add3(sigma1(W[32 - 2]), W[32 - 7], pre[5]);
+    W[33] = add4(sigma1(W[33 - 2]), W[33 - 7], sigma0(W[33 - 15]), W[33 - 16]);
+    W[34] = add4(sigma1(W[34 - 2]), W[34 - 7], sigma0(W[34 - 15]), W[34 - 16]);
+    W[35] = add4(sigma1(W[35 - 2]), W[35 - 7], sigma0(W[35 - 15]), W[35 - 16]);
+    W[36] = add4(sigma1(W[36 - 2]), W[36 - 7], sigma0(W[36 - 15]), W[36 - 16]);
+    W[37] = add4(sigma1(W[37 - 2]), W[37 - 7], sigma0(W[37 - 15]), W[37 - 16]);
+    W[38] = add4(sigma1(W[38 - 2]), W[38 - 7], sigma0(W[38 - 15]), W[38 - 16]);
+    W[39] = add4(sigma1(W[39 - 2]), W[39 - 7], sigma0(W[39 - 15]), W[39 - 16]);
+    W[40] = add4(sigma1(W[40 - 2]), W[40 - 7], sigma0(W[40 - 15]), W[40 - 16]);
+    W[41] = add4(sigma1(W[41 - 2]), W[41 - 7], sigma0(W[41 - 15]), W[41 - 16]);
+    W[42] = add4(sigma1(W[42 - 2]), W[42 - 7], sigma0(W[42 - 15]), W[42 - 16]);
+    W[43] = add4(sigma1(W[43 - 2]), W[43 - 7], sigma0(W[43 - 15]), W[43 - 16]);
+    W[44] = add4(sigma1(W[44 - 2]), W[44 - 7], sigma0(W[44 - 15]), W[44 - 16]);
+    W[45] = add4(sigma1(W[45 - 2]), W[45 - 7], sigma0(W[45 - 15]), W[45 - 16]);
+    W[46] = add4(sigma1(W[46 - 2]), W[46 - 7], sigma0(W[46 - 15]), W[46 - 16]);
+    W[47] = add4(sigma1(W[47 - 2]), W[47 - 7], sigma0(W[47 - 15]), W[47 - 16]);
+    W[48] = add4(sigma1(W[48 - 2]), W[48 - 7], sigma0(W[48 - 15]), W[48 - 16]);
+    W[49] = add4(sigma1(W[49 - 2]), W[49 - 7], sigma0(W[49 - 15]), W[49 - 16]);
+    W[50] = add4(sigma1(W[50 - 2]), W[50 - 7], sigma0(W[50 - 15]), W[50 - 16]);
+    W[51] = add4(sigma1(W[51 - 2]), W[51 - 7], sigma0(W[51 - 15]), W[51 - 16]);
+    W[52] = add4(sigma1(W[52 - 2]), W[52 - 7], sigma0(W[52 - 15]), W[52 - 16]);
+    W[53] = add4(sigma1(W[53 - 2]), W[53 - 7], sigma0(W[53 - 15]), W[53 - 16]);
+    W[54] = add4(sigma1(W[54 - 2]), W[54 - 7], sigma0(W[54 - 15]), W[54 - 16]);
+    W[55] = add4(sigma1(W[55 - 2]), W[55 - 7], sigma0(W[55 - 15]), W[55 - 16]);
+    W[56] = add4(sigma1(W[56 - 2]), W[56 - 7], sigma0(W[56 - 15]), W[56 - 16]);
+    W[57] = add4(sigma1(W[57 - 2]), W[57 - 7], sigma0(W[57 - 15]), W[57 - 16]);
+    W[58] = add4(sigma1(W[58 - 2]), W[58 - 7], sigma0(W[58 - 15]), W[58 - 16]);
+    W[59] = add4(sigma1(W[59 - 2]), W[59 - 7], sigma0(W[59 - 15]), W[59 - 16]);
+    W[60] = add4(sigma1(W[60 - 2]), W[60 - 7], sigma0(W[60 - 15]), W[60 - 16]);
+    W[61] = add4(sigma1(W[61 - 2]), W[61 - 7], sigma0(W[61 - 15]), W[61 - 16]);
+    W[62] = add4(sigma1(W[62 - 2]), W[62 - 7], sigma0(W[62 - 15]), W[62 - 16]);
+    W[63] = add4(sigma1(W[63 - 2]), W[63 - 7], sigma0(W[63 - 15]), W[63 - 16]);
+
+    // complete the fourth round with the nonce
+    __m256i a = add2(mid[0], nonce);
+    __m256i b = mid[1];
+    __m256i c = mid[2];
+    __m256i d = mid[3];
+    __m256i e = add2(mid[4], nonce);
+    __m256i f = mid[5];
+    __m256i g = mid[6];
+    __m256i h = mid[7];
+
+    t1 = add4(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0xb956c25b));
     t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
-    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x59f111f1), W[5]);
+    t1 = add4(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x59f111f1));
     t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
-    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x923f82a4), W[6]);
+    t1 = add4(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x923f82a4));
     t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
-    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xab1c5ed5), W[7]);
+    t1 = add4(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xab1c5ed5));
     t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
 
-    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0xd807aa98), W[8]);
+    t1 = add4(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0xd807aa98));
     t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
-    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x25635b01), W[9]);
+    t1 = add4(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x12835b01));
     t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
-    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x243185be), W[10]);
+    t1 = add4(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x243185be));
     t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
-    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x550c7dc3), W[11]);
+    t1 = add4(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x550c7dc3));
     t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
-    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x72be5d74), W[12]);
+    t1 = add4(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x72be5d74));
     t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
-    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x80deb1fe), W[13]);
+    t1 = add4(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x80deb1fe));
     t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
-    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x9bdc06a7), W[14]);
+    t1 = add4(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x9bdc06a7));
     t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
-    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xc19bf174), W[15]);
+    t1 = add4(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xc19bf3f4));
     t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
 
     t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0xe49b69c1), W[16]);
@@ -246,7 +913,7 @@ static inline void sha256_transform(__m256i *state, __m256i *block, __m256i *dst
     t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
     t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xc67178f2), W[63]);
     t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
-    
+
     dst[0] = add2(state[0], a);
     dst[1] = add2(state[1], b);
     dst[2] = add2(state[2], c);
@@ -257,6 +924,211 @@ static inline void sha256_transform(__m256i *state, __m256i *block, __m256i *dst
     dst[7] = add2(state[7], h);
 }
 
+// transforms the round 2 block from the initial SHA-256 state, returning only the last word of the state less its
+// initial value; the remainder of the block is the fixed SHA-256 padding of a 32 byte hash
+static inline __m256i sha256_transform_final(__m256i *block)
+{
+    __m256i W[61], t1, t2;
+
+    W[0]  = block[0];
+    W[1]  = block[1];
+    W[2]  = block[2];
+    W[3]  = block[3];
+    W[4]  = block[4];
+    W[5]  = block[5];
+    W[6]  = block[6];
+    W[7]  = block[7];
+
+    W[16] = add2(sigma0(W[1]), W[0]);
+    W[17] = add3(_mm256_set1_epi32(0x00a00000), sigma0(W[2]), W[1]);
+    W[18] = add3(sigma1(W[18 - 2]), sigma0(W[18 - 15]), W[18 - 16]);
+    W[19] = add3(sigma1(W[19 - 2]), sigma0(W[19 - 15]), W[19 - 16]);
+    W[20] = add3(sigma1(W[20 - 2]), sigma0(W[20 - 15]), W[20 - 16]);
+    W[21] = add3(sigma1(W[21 - 2]), sigma0(W[21 - 15]), W[21 - 16]);
+    W[22] = add4(sigma1(W[22 - 2]), _mm256_set1_epi32(0x00000100), sigma0(W[22 - 15]), W[22 - 16]);
+    W[23] = add4(sigma1(W[23 - 2]), W[23 - 7], _mm256_set1_epi32(0x11002000), W[23 - 16]);
+    W[24] = add3(sigma1(W[24 - 2]), W[24 - 7], _mm256_set1_epi32(0x80000000));
+    W[25] = add2(sigma1(W[25 - 2]), W[25 - 7]);
+    W[26] = add2(sigma1(W[26 - 2]), W[26 - 7]);
+    W[27] = add2(sigma1(W[27 - 2]), W[27 - 7]);
+    W[28] = add2(sigma1(W[28 - 2]), W[28 - 7]);
+    W[29] = add2(sigma1(W[29 - 2]), W[29 - 7]);
+    W[30] = add3(sigma1(W[30 - 2]), W[30 - 7], _mm256_set1_epi32(0x00400022));
+    W[31] = add4(sigma1(W[31 - 2]), W[31 - 7], sigma0(W[31 - 15]), _mm256_set1_epi32(0x00000100));
+    W[32] = add4(sigma1(W[32 - 2]), W[32 - 7], sigma0(W[32 - 15]), W[32 - 16]);
+    W[33] = add4(sigma1(W[33 - 2]), W[33 - 7], sigma0(W[33 - 15]), W[33 - 16]);
+    W[34] = add4(sigma1(W[34 - 2]), W[34 - 7], sigma0(W[34 - 15]), W[34 - 16]);
+    W[35] = add4(sigma1(W[35 - 2]), W[35 - 7], sigma0(W[35 - 15]), W[35 - 16]);
+    W[36] = add4(sigma1(W[36 - 2]), W[36 - 7], sigma0(W[36 - 15]), W[36 - 16]);
+    W[37] = add4(sigma1(W[37 - 2]), W[37 - 7], sigma0(W[37 - 15]), W[37 - 16]);
+    W[38] = add4(sigma1(W[38 - 2]), W[38 - 7], sigma0(W[38 - 15]), W[38 - 16]);
+    W[39] = add4(sigma1(W[39 - 2]), W[39 - 7], sigma0(W[39 - 15]), W[39 - 16]);
+    W[40] = add4(sigma1(W[40 - 2]), W[40 - 7], sigma0(W[40 - 15]), W[40 - 16]);
+    W[41] = add4(sigma1(W[41 - 2]), W[41 - 7], sigma0(W[41 - 15]), W[41 - 16]);
+    W[42] = add4(sigma1(W[42 - 2]), W[42 - 7], sigma0(W[42 - 15]), W[42 - 16]);
+    W[43] = add4(sigma1(W[43 - 2]), W[43 - 7], sigma0(W[43 - 15]), W[43 - 16]);
+    W[44] = add4(sigma1(W[44 - 2]), W[44 - 7], sigma0(W[44 - 15]), W[44 - 16]);
+    W[45] = add4(sigma1(W[45 - 2]), W[45 - 7], sigma0(W[45 - 15]), W[45 - 16]);
+    W[46] = add4(sigma1(W[46 - 2]), W[46 - 7], sigma0(W[46 - 15]), W[46 - 16]);
+    W[47] = add4(sigma1(W[47 - 2]), W[47 - 7], sigma0(W[47 - 15]), W[47 - 16]);
+    W[48] = add4(sigma1(W[48 - 2]), W[48 - 7], sigma0(W[48 - 15]), W[48 - 16]);
+    W[49] = add4(sigma1(W[49 - 2]), W[49 - 7], sigma0(W[49 - 15]), W[49 - 16]);
+    W[50] = add4(sigma1(W[50 - 2]), W[50 - 7], sigma0(W[50 - 15]), W[50 - 16]);
+    W[51] = add4(sigma1(W[51 - 2]), W[51 - 7], sigma0(W[51 - 15]), W[51 - 16]);
+    W[52] = add4(sigma1(W[52 - 2]), W[52 - 7], sigma0(W[52 - 15]), W[52 - 16]);
+    W[53] = add4(sigma1(W[53 - 2]), W[53 - 7], sigma0(W[53 - 15]), W[53 - 16]);
+    W[54] = add4(sigma1(W[54 - 2]), W[54 - 7], sigma0(W[54 - 15]), W[54 - 16]);
+    W[55] = add4(sigma1(W[55 - 2]), W[55 - 7], sigma0(W[55 - 15]), W[55 - 16]);
+    W[56] = add4(sigma1(W[56 - 2]), W[56 - 7], sigma0(W[56 - 15]), W[56 - 16]);
+    W[57] = add4(sigma1(W[57 - 2]), W[57 - 7], sigma0(W[57 - 15]), W[57 - 16]);
+    W[58] = add4(sigma1(W[58 - 2]), W[58 - 7], sigma0(W[58 - 15]), W[58 - 16]);
+    W[59] = add4(sigma1(W[59 - 2]), W[59 - 7], sigma0(W[59 - 15]), W[59 - 16]);
+    W[60] = add4(sigma1(W[60 - 2]), W[60 - 7], sigma0(W[60 - 15]), W[60 - 16]);
+
+    // initial state, with the first round applied
+    __m256i a = _mm256_set1_epi32(0x6a09e667);
+    __m256i b = _mm256_set1_epi32(0xbb67ae85);
+    __m256i c = _mm256_set1_epi32(0x3c6ef372);
+    __m256i d = add2(_mm256_set1_epi32(0x98c7e2a2), W[0]);
+    __m256i e = _mm256_set1_epi32(0x510e527f);
+    __m256i f = _mm256_set1_epi32(0x9b05688c);
+    __m256i g = _mm256_set1_epi32(0x1f83d9ab);
+    __m256i h = add2(_mm256_set1_epi32(0xfc08884d), W[0]);
+
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x71374491), W[1]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0xb5c0fbcf), W[2]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0xe9b5dba5), W[3]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x3956c25b), W[4]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x59f111f1), W[5]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x923f82a4), W[6]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xab1c5ed5), W[7]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add4(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x5807aa98));
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add4(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x12835b01));
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add4(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x243185be));
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add4(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x550c7dc3));
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add4(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x72be5d74));
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add4(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x80deb1fe));
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add4(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x9bdc06a7));
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add4(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0xc19bf274));
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0xe49b69c1), W[16]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0xefbe4786), W[17]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x0fc19dc6), W[18]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x240ca1cc), W[19]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x2de92c6f), W[20]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x4a7484aa), W[21]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x5cb0a9dc), W[22]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x76f988da), W[23]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x983e5152), W[24]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0xa831c66d), W[25]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0xb00327c8), W[26]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0xbf597fc7), W[27]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0xc6e00bf3), W[28]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0xd5a79147), W[29]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x06ca6351), W[30]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x14292967), W[31]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x27b70a85), W[32]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x2e1b2138), W[33]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x4d2c6dfc), W[34]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x53380d13), W[35]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x650a7354), W[36]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x766a0abb), W[37]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x81c2c92e), W[38]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x92722c85), W[39]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0xa2bfe8a1), W[40]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0xa81a664b), W[41]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0xc24b8b70), W[42]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0xc76c51a3), W[43]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0xd192e819), W[44]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0xd6990624), W[45]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0xf40e3585), W[46]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x106aa070), W[47]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x19a4c116), W[48]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x1e376c08), W[49]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x2748774c), W[50]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x34b0bcb5), W[51]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x391c0cb3), W[52]);
+    t2 = add2(Sigma0(e), Maj(e, f, g)); h = add2(h, t1); d = add2(t1, t2);
+    t1 = add5(c, Sigma1(h), Ch(h, a, b), _mm256_set1_epi32(0x4ed8aa4a), W[53]);
+    t2 = add2(Sigma0(d), Maj(d, e, f)); g = add2(g, t1); c = add2(t1, t2);
+    t1 = add5(b, Sigma1(g), Ch(g, h, a), _mm256_set1_epi32(0x5b9cca4f), W[54]);
+    t2 = add2(Sigma0(c), Maj(c, d, e)); f = add2(f, t1); b = add2(t1, t2);
+    t1 = add5(a, Sigma1(f), Ch(f, g, h), _mm256_set1_epi32(0x682e6ff3), W[55]);
+    t2 = add2(Sigma0(b), Maj(b, c, d)); e = add2(e, t1); a = add2(t1, t2);
+
+    t1 = add5(h, Sigma1(e), Ch(e, f, g), _mm256_set1_epi32(0x748f82ee), W[56]);
+    t2 = add2(Sigma0(a), Maj(a, b, c)); d = add2(d, t1); h = add2(t1, t2);
+    t1 = add5(g, Sigma1(d), Ch(d, e, f), _mm256_set1_epi32(0x78a5636f), W[57]);
+    t2 = add2(Sigma0(h), Maj(h, a, b)); c = add2(c, t1); g = add2(t1, t2);
+    t1 = add5(f, Sigma1(c), Ch(c, d, e), _mm256_set1_epi32(0x84c87814), W[58]);
+    t2 = add2(Sigma0(g), Maj(g, h, a)); b = add2(b, t1); f = add2(t1, t2);
+    t1 = add5(e, Sigma1(b), Ch(b, c, d), _mm256_set1_epi32(0x8cc70208), W[59]);
+    t2 = add2(Sigma0(f), Maj(f, g, h)); a = add2(a, t1); e = add2(t1, t2);
+
+    // only the last word of the state is tested, which is final after this round
+    t1 = add5(d, Sigma1(a), Ch(a, b, c), _mm256_set1_epi32(0x90befffa), W[60]);
+
+    return add2(h, t1);
+}
+
+#endif
+
 bool __AvxDetect()
 {
     int cpuInfo[4];
@@ -275,10 +1147,11 @@ bool __AvxDetect()
     return false;
 }
 
-bool __AvxSearch(unsigned int *round1State, unsigned char *round1Block2, unsigned __int32 *round2State, unsigned char *round2Block1, unsigned __int32 *nonce_, avxCheckFunc check)
+bool __AvxSearch(unsigned int *round1State, unsigned char *round1Block2, unsigned __int32 start, unsigned __int64 count, const volatile unsigned __int32 *generation, unsigned __int32 expected, unsigned __int32 *nonce_, avxCheckFunc check)
 {
-    // starting nonce
-    unsigned int nonce = 0;
+    // starting nonce, and number of nonces searched so far
+    unsigned int nonce = start;
+    unsigned __int64 done = 0;
 
     // vector containing input round1 state
     __m256i round1State_m256i[8];
@@ -290,18 +1163,17 @@ bool __AvxSearch(unsigned int *round1State, unsigned char *round1Block2, unsigne
     for (int i = 0; i < 16; i++)
         round1Block2_m256i[i] = _mm256_set1_epi32(((unsigned __int32*)round1Block2)[i]);
 
-    // vector containing input round 2 state, initialized
-    __m256i round2State_m256i[8];
-    for (int i = 0; i < 8; i++)
-        round2State_m256i[i] = _mm256_set1_epi32(round2State[i]);
+    // values of round 1 block 2 which do not depend on the nonce, calculated once per work
+    __m256i round1Mid_m256i[8];
+    __m256i round1Pre_m256i[6];
+    sha256_precalc(round1State_m256i, round1Block2_m256i, round1Mid_m256i, round1Pre_m256i);
 
-    // vector containing round 2 block, to which the state from round 1 should be output
-    __m256i round2Block1_m256i[16];
-    for (int i = 0; i < 16; i++)
-        round2Block1_m256i[i] = _mm256_set1_epi32(((unsigned __int32*)round2Block1)[i]);
+    // vector containing the first 8 words of round 2 block, to which the state from round 1 should be output; the
+    // round 2 state and remainder of the block are constant and folded into sha256_transform_final
+    __m256i round2Block1_m256i[8];
 
-    // vector containing the final output from round 2
-    __m256i round2State2_m256i[8];
+    // last word of the final output from round 2
+    __m256i round2State2_m256i;
 
     // initial nonce vector
     __m256i nonce_inc_m256i = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
@@ -310,16 +1182,17 @@ bool __AvxSearch(unsigned int *round1State, unsigned char *round1Block2, unsigne
     {
         // set nonce in blocks
         __m256i g = _mm256_set1_epi32(nonce);
-        round1Block2_m256i[3] = _mm256_add_epi32(g, nonce_inc_m256i);
+        __m256i nonce_m256i = _mm256_add_epi32(g, nonce_inc_m256i);
         
         // transform variable second half of block using saved state from first block, into pre-padded round 2 block (end of first hash)
-        sha256_transform(round1State_m256i, round1Block2_m256i, round2Block1_m256i);
+        sha256_transform_nonce(round1State_m256i, round1Mid_m256i, round1Pre_m256i, nonce_m256i, round2Block1_m256i);
 
         // transform round 2 block into round 2 state (second hash)
-        sha256_transform(round2State_m256i, round2Block1_m256i, round2State2_m256i);
+        round2State2_m256i = sha256_transform_final(round2Block1_m256i);
         
-        // isolate 0x00000000, segment to uint64 for easier testing
-        __m256i p = _mm256_cmpeq_epi32(round2State2_m256i[7], _mm256_setzero_si256());
+        // isolate 0x00000000 in the final state, which is 0xa41f32e7 before the initial state is added back; segment
+        // to uint64 for easier testing
+        __m256i p = _mm256_cmpeq_epi32(round2State2_m256i, _mm256_set1_epi32(0xa41f32e7));
         unsigned __int64 *p64 = (unsigned __int64*)&p;
 
         // one of the two sides of the vector has values
@@ -382,10 +1255,115 @@ bool __AvxSearch(unsigned int *round1State, unsigned char *round1Block2, unsigne
             }
         }
 
-        // report progress, or check overflow
-        if ((nonce += 8) % 65536 == 0)
-            if (!check(65536) || nonce < 8)
+        nonce += 8;
+        done += 8;
+
+        // abort as soon as the pool moves on to a new block; report progress, or check for the end of the range
+        if (done % 4096 == 0)
+        {
+            if (*generation != expected)
+                break;
+
+            if (done % 65536 == 0)
+                if (!check(65536) || done >= count)
+                    break;
+        }
+    }
+
+    return false;
+}
+
+bool __AvxSearchPacked(unsigned int *round1State, unsigned char *round1Block2, unsigned int works, unsigned __int32 *start, unsigned __int64 count, const volatile unsigned __int32 **generation, unsigned __int32 *expected, unsigned __int32 *index_, unsigned __int32 *nonce_, avxCheckFunc check)
+{
+    // each work is carried by a group of adjacent lanes, which step through the nonce range together
+    if (works == 0 || 8 % works != 0)
+        return false;
+
+    unsigned int stride = 8 / works;
+
+    // number of nonces of each work searched so far
+    unsigned int nonce = 0;
+    unsigned __int64 done = 0;
+
+    // work index and starting nonce of each lane
+    unsigned __int32 laneWork[8], laneNonce[8], lane[8];
+    for (int i = 0; i < 8; i++)
+    {
+        laneWork[i] = i / stride;
+        laneNonce[i] = start[i / stride] + i % stride;
+    }
+
+    // vector containing input round1 state, structure-of-arrays across the works
+    __m256i round1State_m256i[8];
+    for (int i = 0; i < 8; i++)
+    {
+        for (int j = 0; j < 8; j++)
+            lane[j] = round1State[laneWork[j] * 8 + i];
+        round1State_m256i[i] = _mm256_loadu_si256((__m256i*)lane);
+    }
+
+    // vector containing input round 1 block 2 of each work, contains the nonce field
+    __m256i round1Block2_m256i[16];
+    for (int i = 0; i < 16; i++)
+    {
+        for (int j = 0; j < 8; j++)
+            lane[j] = ((unsigned __int32*)round1Block2)[laneWork[j] * 16 + i];
+        round1Block2_m256i[i] = _mm256_loadu_si256((__m256i*)lane);
+    }
+
+    // values of round 1 block 2 which do not depend on the nonce, calculated once per set of works
+    __m256i round1Mid_m256i[8];
+    __m256i round1Pre_m256i[6];
+    sha256_precalc(round1State_m256i, round1Block2_m256i, round1Mid_m256i, round1Pre_m256i);
+
+    // vector containing the first 8 words of round 2 block
+    __m256i round2Block1_m256i[8];
+
+    // last word of the final output from round 2
+    __m256i round2State2_m256i;
+
+    // initial nonce vector
+    __m256i nonce_inc_m256i = _mm256_loadu_si256((__m256i*)laneNonce);
+
+    for (;;)
+    {
+        // set nonce in blocks
+        __m256i nonce_m256i = _mm256_add_epi32(_mm256_set1_epi32(nonce), nonce_inc_m256i);
+
+        // transform variable second half of block using saved state from first block, into pre-padded round 2 block (end of first hash)
+        sha256_transform_nonce(round1State_m256i, round1Mid_m256i, round1Pre_m256i, nonce_m256i, round2Block1_m256i);
+
+        // transform round 2 block into round 2 state (second hash)
+        round2State2_m256i = sha256_transform_final(round2Block1_m256i);
+
+        // isolate 0x00000000 in the final state, one bit per lane
+        int p = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(round2State2_m256i, _mm256_set1_epi32(0xa41f32e7))));
+        if (p != 0)
+            for (int i = 0; i < 8; i++)
+                if (p & (1 << i))
+                {
+                    *index_ = laneWork[i];
+                    *nonce_ = endian_swap(nonce + laneNonce[i]);
+                    return true;
+                }
+
+        nonce += stride;
+        done += stride;
+
+        // abort as soon as the pool of any work moves on to a new block; report progress of all works, or check for
+        // the end of the range
+        if (done % 4096 == 0)
+        {
+            bool stale = false;
+            for (unsigned int i = 0; i < works; i++)
+                stale |= *generation[i] != expected[i];
+            if (stale)
                 break;
+
+            if (done % 65536 == 0)
+                if (!check(65536 * works) || done >= count)
+                    break;
+        }
     }
 
     return false;
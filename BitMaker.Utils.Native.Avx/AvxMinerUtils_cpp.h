@@ -3,8 +3,12 @@
 // signature of managed status function
 typedef bool (*avxCheckFunc)(int);
 
-// signature of unmanaged search implementation
-bool __AvxSearch(unsigned int *round1State, unsigned char *round1Block2, unsigned __int32 *round2State, unsigned char *round2Block1, unsigned __int32 *nonce_, avxCheckFunc check);
+// signature of unmanaged search implementation, over count nonces from start; count must be a multiple of 65536,
+// and the search is abandoned once *generation no longer equals expected
+bool __AvxSearch(unsigned int *round1State, unsigned char *round1Block2, unsigned __int32 start, unsigned __int64 count, const volatile unsigned __int32 *generation, unsigned __int32 expected, unsigned __int32 *nonce_, avxCheckFunc check);
+
+// signature of unmanaged search implementation across several works, one per group of lanes
+bool __AvxSearchPacked(unsigned int *round1State, unsigned char *round1Block2, unsigned int works, unsigned __int32 *start, unsigned __int64 count, const volatile unsigned __int32 **generation, unsigned __int32 *expected, unsigned __int32 *index_, unsigned __int32 *nonce_, avxCheckFunc check);
 
 // signature of unmanaged AVX detection implementation
 bool __AvxDetect();
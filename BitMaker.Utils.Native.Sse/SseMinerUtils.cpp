@@ -22,32 +22,81 @@ namespace BitMaker
 
             public:
 
+                // number of vector lanes searched at once
+                literal int Lanes = 4;
+
 				static bool Detect()
 				{
 					return __SseDetect();
 				}
 
-                static Nullable<unsigned int> Search(unsigned int* round1State, unsigned char* round1Block1, unsigned int* round2State, unsigned char* round2Block1, SseCheckDelegate^ check)
+                // searches count nonces beginning at start, count being a multiple of 65536, until the value at
+                // generation no longer equals expected
+                static Nullable<unsigned int> Search(unsigned int* round1State, unsigned char* round1Block1, unsigned int start, unsigned long long count, unsigned int* generation, unsigned int expected, SseCheckDelegate^ check)
                 {
+                    if (count == 0 || count % 65536 != 0)
+                        throw gcnew ArgumentOutOfRangeException("count");
+
                     unsigned int nonce;
                     
-                    // create function pointer for 'status', and ensure it doesn't get collected
-                    GCHandle checkH = GCHandle::Alloc(check);
+                    // function pointer for 'status'; the thunk lives as long as the delegate, which callers are expected to
+                    // hold on to across searches rather than create for each
+                    sseCheckFunc checkPtr = (sseCheckFunc)(void*)Marshal::GetFunctionPointerForDelegate(check);
+
+                    try
+                    {
+                        if (__SseSearch(round1State, round1Block1, start, count, generation, expected, &nonce, checkPtr))
+                            return Nullable<unsigned int>(nonce);
+                        else
+                            return Nullable<unsigned int>();
+                    }
+                    finally
+                    {
+                        GC::KeepAlive(check);
+                    }
+                }
+
+                // searches works at once, each carried by Lanes / works lanes, with their states and blocks laid out one
+                // after another; each work is searched over count nonces from its own start; returns the nonce found
+                // and the index of the work it belongs to
+                static Nullable<unsigned int> SearchPacked(unsigned int* round1States, unsigned char* round1Blocks2, unsigned int works, unsigned int* starts, unsigned long long count, unsigned int** generations, unsigned int* expected, [Out] unsigned int% index, SseCheckDelegate^ check)
+                {
+                    if (works == 0 || Lanes % works != 0)
+                        throw gcnew ArgumentOutOfRangeException("works");
+                    if (count == 0 || count % 65536 != 0)
+                        throw gcnew ArgumentOutOfRangeException("count");
+
+                    unsigned int index_, nonce;
+
+                    // function pointer for 'status'; the thunk lives as long as the delegate, which callers are expected to
+                    // hold on to across searches rather than create for each
                     sseCheckFunc checkPtr = (sseCheckFunc)(void*)Marshal::GetFunctionPointerForDelegate(check);
 
                     try
                     {
-                        if (__SseSearch(round1State, round1Block1, round2State, round2Block1, &nonce, checkPtr))
+                        index = 0;
+
+                        if (__SseSearchPacked(round1States, round1Blocks2, works, starts, count, (const volatile unsigned int**)generations, expected, &index_, &nonce, checkPtr))
+                        {
+                            index = index_;
                             return Nullable<unsigned int>(nonce);
+                        }
                         else
                             return Nullable<unsigned int>();
                     }
                     finally
                     {
-                        checkH.Free();
+                        GC::KeepAlive(check);
                     }
                 }
 
+                // calculates the double SHA-256 hashes of count 80 byte block headers, writing each 32 byte hash to hashes
+                // in the order of headers
+                static void HashHeaders(unsigned char** headers, unsigned int count, unsigned char* hashes)
+                {
+                    __SseHashHeaders((const unsigned char**)headers, count, hashes);
+                }
+
             };
 
         }
@@ -3,8 +3,16 @@
 // signature of managed status function
 typedef bool (*sseCheckFunc)(int);
 
-// signature of unmanaged search implementation
-bool __SseSearch(unsigned int *round1State, unsigned char *round1Block2, unsigned __int32 *round2State, unsigned char *round2Block1, unsigned __int32 *nonce_, sseCheckFunc check);
+// signature of unmanaged search implementation, over count nonces from start; count must be a multiple of 65536,
+// and the search is abandoned once *generation no longer equals expected
+bool __SseSearch(unsigned int *round1State, unsigned char *round1Block2, unsigned __int32 start, unsigned __int64 count, const volatile unsigned __int32 *generation, unsigned __int32 expected, unsigned __int32 *nonce_, sseCheckFunc check);
+
+// signature of unmanaged search implementation across several works, one per group of lanes
+bool __SseSearchPacked(unsigned int *round1State, unsigned char *round1Block2, unsigned int works, unsigned __int32 *start, unsigned __int64 count, const volatile unsigned __int32 **generation, unsigned __int32 *expected, unsigned __int32 *index_, unsigned __int32 *nonce_, sseCheckFunc check);
+
+// signature of unmanaged double SHA-256 of count 80 byte block headers, four at a time, each 32 byte hash written to
+// hashes in the order of headers
+void __SseHashHeaders(const unsigned char **headers, unsigned int count, unsigned char *hashes);
 
 // signature of unmanaged SSE detection implementation
 bool __SseDetect();
\ No newline at end of file
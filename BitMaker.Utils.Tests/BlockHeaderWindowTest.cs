@@ -0,0 +1,88 @@
+﻿using System.Runtime.InteropServices;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace BitMaker.Utils.Tests
+{
+
+    [TestClass()]
+    public class BlockHeaderWindowTest
+    {
+
+        // genesis block header, and its hash in byte order
+        static readonly byte[] GenesisHeader = Memory.Decode("0100000000000000000000000000000000000000000000000000000000000000000000003ba3edfd7a7b12b27ac72c3e67768f617fc81bc3888a51323a9fb8aa4b1e5e4a29ab5f49ffff001d1dac2b7c");
+        static readonly byte[] GenesisHash = Memory.Decode("6fe28c0ab6f1b372c1a6a246ae63f74f931e8365e15a089c68d6190000000000");
+
+        [TestMethod()]
+        public unsafe void LayoutTest()
+        {
+            Assert.AreEqual(80, sizeof(BlockHeaderWindow));
+            Assert.AreEqual(36, (int)Marshal.OffsetOf(typeof(BlockHeaderWindow), "MerkleRoot"));
+
+            fixed (byte* headerPtr = GenesisHeader)
+            {
+                var header = (BlockHeaderWindow*)headerPtr;
+                Assert.AreEqual(1U, header->Version);
+                Assert.AreEqual(0x3b, header->MerkleRoot[0]);
+                Assert.AreEqual(0x495fab29U, header->Timestamp);
+                Assert.AreEqual(0x1d00ffffU, header->Difficulty);
+                Assert.AreEqual(0x7c2bac1dU, header->Nonce);
+            }
+        }
+
+        [TestMethod()]
+        public unsafe void GetTargetTest()
+        {
+            var expected = new byte[32];
+            expected[26] = 0xff;
+            expected[27] = 0xff;
+
+            var target = new byte[32];
+            fixed (byte* headerPtr = GenesisHeader, targetPtr = target)
+                Assert.IsTrue(((BlockHeaderWindow*)headerPtr)->GetTarget(targetPtr));
+
+            CollectionAssert.AreEqual(expected, target);
+        }
+
+        [TestMethod()]
+        public unsafe void GetTargetTestInvalid()
+        {
+            var header = new BlockHeaderWindow();
+            var target = stackalloc byte[32];
+
+            // negative
+            header.Difficulty = 0x1d80ffffU;
+            Assert.IsFalse(header.GetTarget(target));
+
+            // overflow
+            header.Difficulty = 0x2300ffffU;
+            Assert.IsFalse(header.GetTarget(target));
+
+            // small exponent
+            header.Difficulty = 0x02123456U;
+            Assert.IsTrue(header.GetTarget(target));
+            Assert.AreEqual(0x34, target[0]);
+            Assert.AreEqual(0x12, target[1]);
+            Assert.AreEqual(0x00, target[2]);
+        }
+
+        [TestMethod()]
+        public unsafe void MeetsTargetTest()
+        {
+            var target = stackalloc byte[32];
+
+            fixed (byte* headerPtr = GenesisHeader, hashPtr = GenesisHash)
+            {
+                Assert.IsTrue(((BlockHeaderWindow*)headerPtr)->GetTarget(target));
+                Assert.IsTrue(BlockHeaderWindow.MeetsTarget(hashPtr, target));
+
+                // a hash meets a target equal to it, but not one less than it
+                Memory.Copy(hashPtr, target, 32);
+                Assert.IsTrue(BlockHeaderWindow.MeetsTarget(hashPtr, target));
+                target[0]--;
+                Assert.IsFalse(BlockHeaderWindow.MeetsTarget(hashPtr, target));
+            }
+        }
+
+    }
+
+}
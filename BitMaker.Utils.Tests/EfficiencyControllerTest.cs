@@ -0,0 +1,41 @@
+﻿using System;
+using System.Diagnostics;
+using BitMaker.Miner;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace BitMaker.Utils.Tests
+{
+
+    [TestClass()]
+    public class EfficiencyControllerTest
+    {
+
+        [TestMethod()]
+        public void MeasureTest()
+        {
+            // one million hashes per second at 50 watts
+            var stopwatch = Stopwatch.StartNew();
+            var energy = new StubEnergySource(50);
+            var controller = new EfficiencyController(energy, () => stopwatch.ElapsedTicks * 1000000 / Stopwatch.Frequency, EfficiencyPolicy.Efficiency);
+
+            var actual = controller.Measure("stub", TimeSpan.FromMilliseconds(500));
+            Assert.AreEqual(1000000, actual.HashesPerSecond, 50000);
+            Assert.AreEqual(50, actual.Watts, 2.5);
+            Assert.AreEqual(20000, actual.HashesPerJoule, 2000);
+        }
+
+        [TestMethod()]
+        public void SelectTest()
+        {
+            var fast = new EfficiencySample() { Name = "fast", HashesPerSecond = 200, Watts = 100 };
+            var frugal = new EfficiencySample() { Name = "frugal", HashesPerSecond = 150, Watts = 50 };
+            var curve = new[] { fast, frugal };
+
+            var energy = new StubEnergySource(0);
+            Assert.AreSame(fast, new EfficiencyController(energy, () => 0, EfficiencyPolicy.Throughput).Select(curve));
+            Assert.AreSame(frugal, new EfficiencyController(energy, () => 0, EfficiencyPolicy.Efficiency).Select(curve));
+        }
+
+    }
+
+}
@@ -0,0 +1,95 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Threading;
+using BitMaker.Miner;
+using BitMaker.Miner.Cpu;
+using BitMaker.Miner.Managed;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace BitMaker.Utils.Tests
+{
+
+    [TestClass()]
+    public class ManagedMinerTest
+    {
+
+        /// <summary>
+        /// Context which hands out the given work once each, records the work submitted by the miner, and signals when
+        /// the miner asks for work after the last.
+        /// </summary>
+        class SearchContext : IMinerContext
+        {
+
+            public readonly Queue<Work> Works = new Queue<Work>();
+
+            public readonly List<Work> Submitted = new List<Work>();
+
+            public readonly ManualResetEvent Done = new ManualResetEvent(false);
+
+            public Work GetWork(IMiner miner, string comment)
+            {
+                lock (Works)
+                    if (Works.Count > 0)
+                        return Works.Dequeue();
+
+                Done.Set();
+                Thread.Sleep(100);
+                return null;
+            }
+
+            public bool SubmitWork(IMiner miner, Work work, string comment)
+            {
+                lock (Submitted)
+                    Submitted.Add(work);
+
+                return true;
+            }
+
+            public void ReportHashes(IMiner plugin, long count)
+            {
+
+            }
+
+        }
+
+        /// <summary>
+        /// Returns the given range of the sample work, with its nonce cleared.
+        /// </summary>
+        /// <param name="start"></param>
+        /// <param name="count"></param>
+        /// <returns></returns>
+        static Work Split(uint start, long count)
+        {
+            var work = Utils.Work.Split(start, count);
+            Array.Clear(work.Header, 76, 4);
+            return work;
+        }
+
+        [TestMethod()]
+        public void SearchTest()
+        {
+            // the nonce of the sample work lies in the second range only, offset so as not to fall in the first lane
+            // of a vector search
+            var context = new SearchContext();
+            context.Works.Enqueue(Split(0x00010000U, 0x10000));
+            context.Works.Enqueue(Split(0xdf19fffdU, 0x10000));
+
+            var miner = new ManagedMiner(context, new CpuDevice() { Id = "0" });
+            miner.Start();
+
+            try
+            {
+                Assert.IsTrue(context.Done.WaitOne(TimeSpan.FromSeconds(60)));
+            }
+            finally
+            {
+                miner.Stop();
+            }
+
+            Assert.AreEqual(1, context.Submitted.Count);
+            CollectionAssert.AreEqual(Utils.Work.Header, context.Submitted[0].Header);
+        }
+
+    }
+
+}
@@ -0,0 +1,140 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Threading;
+using BitMaker.Miner;
+using BitMaker.Miner.Cpu;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace BitMaker.Utils.Tests
+{
+
+    [TestClass()]
+    public class PackedWorkTest
+    {
+
+        // nonce which solves the sample work, as searched by the kernels
+        static readonly uint Solution = Memory.ReverseEndian(BitConverter.ToUInt32(Utils.Work.Header, 76));
+
+        /// <summary>
+        /// Gets a portion of the sample work with the nonce cleared from its header.
+        /// </summary>
+        /// <param name="start"></param>
+        /// <param name="count"></param>
+        /// <returns></returns>
+        static Work Split(uint start, long count)
+        {
+            var work = Utils.Work.Split(start, count);
+            Array.Clear(work.Header, 76, 4);
+            return work;
+        }
+
+        /// <summary>
+        /// Context which hands out the given works, followed by portions of the sample work without a solution.
+        /// </summary>
+        class PackedContext : IMinerContext
+        {
+
+            public readonly Queue<Work> Works = new Queue<Work>();
+
+            public readonly ManualResetEvent Solved = new ManualResetEvent(false);
+
+            public Work Submitted;
+
+            uint filler = 0x80000000U;
+
+            public Work GetWork(IMiner miner, string comment)
+            {
+                if (Works.Count > 0)
+                    return Works.Dequeue();
+
+                filler += 0x10000U;
+                return Split(filler, 0x10000L);
+            }
+
+            public bool SubmitWork(IMiner miner, Work work, string comment)
+            {
+                Submitted = work;
+                Solved.Set();
+                return true;
+            }
+
+            public void ReportHashes(IMiner plugin, long count)
+            {
+
+            }
+
+        }
+
+        /// <summary>
+        /// Miner which searches two works together, recording the ranges searched, and finds the solution of the sample
+        /// work if it lies within them.
+        /// </summary>
+        class PackedMiner : CpuMiner
+        {
+
+            public readonly List<Tuple<uint, long>> Searched = new List<Tuple<uint, long>>();
+
+            public PackedMiner(IMinerContext context)
+                : base(context, new CpuDevice() { Id = "0" })
+            {
+
+            }
+
+            public override int PackedWorkCount
+            {
+                get { return 2; }
+            }
+
+            public override unsafe uint? Search(Work work, uint* round1State, byte* round1Block2)
+            {
+                throw new NotSupportedException();
+            }
+
+            public override unsafe uint? Search(Work[] works, uint* round1States, byte* round1Blocks2, out int index)
+            {
+                lock (Searched)
+                    foreach (var work in works)
+                        Searched.Add(Tuple.Create(work.NonceStart, work.NonceCount));
+
+                for (index = 0; index < works.Length; index++)
+                    if ((uint)(Solution - works[index].NonceStart) < works[index].NonceCount)
+                        return Solution;
+
+                index = 0;
+                return null;
+            }
+
+        }
+
+        [TestMethod()]
+        public void UnequalNonceCountTest()
+        {
+            // a short work without the solution packed with a longer one which has it past the end of the short one
+            var context = new PackedContext();
+            context.Works.Enqueue(Split(0x90000000U, 0x10000L));
+            context.Works.Enqueue(Split(0x00700000U, 0x200000L));
+
+            var miner = new PackedMiner(context);
+            miner.Start();
+
+            try
+            {
+                Assert.IsTrue(context.Solved.WaitOne(TimeSpan.FromSeconds(10)));
+            }
+            finally
+            {
+                miner.Stop();
+            }
+
+            Assert.IsTrue(context.Submitted.Validate());
+            Assert.IsTrue((uint)(Solution - context.Submitted.NonceStart) < context.Submitted.NonceCount);
+
+            // works were searched together over the same number of nonces
+            lock (miner.Searched)
+                for (int i = 0; i < miner.Searched.Count; i += 2)
+                    Assert.AreEqual(miner.Searched[i].Item2, miner.Searched[i + 1].Item2);
+        }
+
+    }
+
+}
@@ -0,0 +1,50 @@
+﻿using System;
+using BitMaker.Miner;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace BitMaker.Utils.Tests
+{
+
+    [TestClass()]
+    public class WorkTest
+    {
+
+        [TestMethod()]
+        public void SplitTest()
+        {
+            var work = Utils.Work;
+            Assert.AreEqual(0U, work.NonceStart);
+            Assert.AreEqual(Work.NONCE_SPACE, work.NonceCount);
+
+            var actual = work.Split(0x00010000U, 0x20000L);
+            Assert.AreEqual(0x00010000U, actual.NonceStart);
+            Assert.AreEqual(0x20000L, actual.NonceCount);
+            Assert.AreEqual(work.BlockNumber, actual.BlockNumber);
+            CollectionAssert.AreEqual(work.Header, actual.Header);
+            Assert.AreNotSame(work.Header, actual.Header);
+        }
+
+        [TestMethod()]
+        [ExpectedException(typeof(ArgumentOutOfRangeException))]
+        public void SplitTestEmpty()
+        {
+            Utils.Work.Split(0, 0);
+        }
+
+        [TestMethod()]
+        [ExpectedException(typeof(ArgumentOutOfRangeException))]
+        public void SplitTestBeyondEnd()
+        {
+            Utils.Work.Split(0x00010000U, 0x20000L).Split(0x00020000U, 0x20000L);
+        }
+
+        [TestMethod()]
+        [ExpectedException(typeof(ArgumentOutOfRangeException))]
+        public void SplitTestBeforeStart()
+        {
+            Utils.Work.Split(0x00010000U, 0x20000L).Split(0x00008000U, 0x8000L);
+        }
+
+    }
+
+}
@@ -16,7 +16,7 @@ namespace BitMaker.Utils
         [FieldOffset(4)]
         public fixed byte PreviousHash[32];
 
-        [FieldOffset(32)]
+        [FieldOffset(36)]
         public fixed byte MerkleRoot[32];
         
         [FieldOffset(68)]
@@ -28,6 +28,55 @@ namespace BitMaker.Utils
         [FieldOffset(76)]
         public uint Nonce;
 
+        /// <summary>
+        /// Expands the compact target encoded in <see cref="Difficulty"/> into the 32 byte little endian number
+        /// <paramref name="target"/>. Returns <c>false</c> if the encoding is negative, zero or overflows, in which case
+        /// no hash can meet it.
+        /// </summary>
+        /// <param name="target"></param>
+        /// <returns></returns>
+        public bool GetTarget(byte* target)
+        {
+            Memory.Zero(target, Sha256.SHA256_HASH_SIZE);
+
+            // base 256 exponent and three byte mantissa, with a sign bit
+            var exponent = (int)(Difficulty >> 24);
+            var mantissa = Difficulty & 0x007fffffU;
+            if ((Difficulty & 0x00800000U) != 0 || mantissa == 0)
+                return false;
+
+            // small exponents shift the mantissa right
+            if (exponent < 3)
+            {
+                mantissa >>= 8 * (3 - exponent);
+                exponent = 3;
+            }
+
+            for (int i = 0; i < 3; i++, mantissa >>= 8)
+                if (exponent - 3 + i < Sha256.SHA256_HASH_SIZE)
+                    target[exponent - 3 + i] = (byte)mantissa;
+                else if ((byte)mantissa != 0)
+                    return false;
+
+            return true;
+        }
+
+        /// <summary>
+        /// Returns whether the 32 byte hash <paramref name="hash"/> does not exceed <paramref name="target"/>, both
+        /// taken as little endian numbers.
+        /// </summary>
+        /// <param name="hash"></param>
+        /// <param name="target"></param>
+        /// <returns></returns>
+        public static bool MeetsTarget(byte* hash, byte* target)
+        {
+            for (int i = 7; i >= 0; i--)
+                if (((uint*)hash)[i] != ((uint*)target)[i])
+                    return ((uint*)hash)[i] < ((uint*)target)[i];
+
+            return true;
+        }
+
     }
 
 }